@@ -0,0 +1,100 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations(0);
+std::atomic<std::size_t> liveBytes(0);
+std::atomic<std::size_t> peakBytes(0);
+
+/** Space in front of every allocation holding its size. */
+const std::size_t HEADER = alignof(std::max_align_t);
+
+void* allocate(std::size_t bytes)
+{
+  char* memory = static_cast<char*>(std::malloc(HEADER + bytes));
+  if (memory == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t*>(memory) = bytes;
+  ++allocations;
+  const std::size_t live = liveBytes += bytes;
+  std::size_t peak = peakBytes;
+  while (live > peak && !peakBytes.compare_exchange_weak(peak, live))
+  {
+  }
+  return memory + HEADER;
+}
+
+void release(void* pointer)
+{
+  if (pointer == nullptr)
+  {
+    return;
+  }
+  char* memory = static_cast<char*>(pointer) - HEADER;
+  liveBytes -= *reinterpret_cast<std::size_t*>(memory);
+  std::free(memory);
+}
+
+}
+
+void* operator new(std::size_t bytes)
+{
+  return allocate(bytes);
+}
+
+void* operator new[](std::size_t bytes)
+{
+  return allocate(bytes);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+  release(pointer);
+}
+
+namespace common { namespace constraints {
+
+std::size_t AllocationCounter::getAllocations()
+{
+  return allocations;
+}
+
+std::size_t AllocationCounter::getLiveBytes()
+{
+  return liveBytes;
+}
+
+std::size_t AllocationCounter::getPeakBytes()
+{
+  return peakBytes;
+}
+
+void AllocationCounter::resetPeak()
+{
+  peakBytes = liveBytes.load();
+}
+
+}}
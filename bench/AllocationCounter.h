@@ -0,0 +1,26 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include <cstddef>
+
+namespace common { namespace constraints {
+
+/** Counts the heap allocations of the whole program, by replacing the global
+    operator new and delete.
+ */
+class AllocationCounter
+{
+public:
+  /** Gets the number of allocations made so far. */
+  static std::size_t getAllocations();
+  /** Gets the number of bytes currently allocated. */
+  static std::size_t getLiveBytes();
+  /** Gets the highest number of bytes allocated at once since the last
+      call to resetPeak.
+   */
+  static std::size_t getPeakBytes();
+  /** Starts tracking the peak from the bytes currently allocated. */
+  static void resetPeak();
+};
+
+}}
@@ -0,0 +1,119 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Generators.h"
+
+#include "LessOrEqual.h"
+
+#include <vector>
+
+namespace {
+
+/** Bound that is never violated by the generated values. */
+const double LIMIT = 1e12;
+
+}
+
+namespace common { namespace constraints {
+
+Wire& makeChain(Network& network, int size)
+{
+  Wire& input = network.make("Input", 1);
+  Wire* wire = &input;
+  for (int i = 0; i < size; ++i)
+  {
+    wire = &(*wire + 1);
+  }
+  *wire <= LIMIT;
+  return input;
+}
+
+Wire& makeConstrainedChain(Network& network, int size)
+{
+  Wire& input = network.make("Input", 1);
+  Wire* wire = &input;
+  for (int i = 0; i < size; ++i)
+  {
+    wire = &(*wire + 1);
+    *wire <= LIMIT + i;
+  }
+  return input;
+}
+
+Wire& makeSumTree(Network& network, int size)
+{
+  std::vector<Wire*> level;
+  for (int i = 0; i < size; ++i)
+  {
+    level.push_back(&network.make(1));
+  }
+  Wire& input = *level.front();
+  while (level.size() > 1)
+  {
+    std::vector<Wire*> sums;
+    for (std::size_t i = 0; i + 1 < level.size(); i += 2)
+    {
+      sums.push_back(&(*level[i] + *level[i + 1]));
+    }
+    if (level.size() % 2 != 0)
+    {
+      sums.push_back(level.back());
+    }
+    level.swap(sums);
+  }
+  *level.front() <= LIMIT;
+  return input;
+}
+
+Wire& makeDiamondLattice(Network& network, int size)
+{
+  const std::size_t WIDTH = 8;
+  Wire& input = network.make("Input", 1);
+  std::vector<Wire*> level(WIDTH, &input);
+  for (int depth = 0; depth < size / static_cast<int>(2 * WIDTH); ++depth)
+  {
+    std::vector<Wire*> next;
+    for (std::size_t i = 0; i < WIDTH; ++i)
+    {
+      next.push_back(&((*level[i] + *level[(i + 1) % WIDTH]) * 0.5));
+    }
+    level.swap(next);
+  }
+  for (auto wire : level)
+  {
+    *wire <= LIMIT;
+  }
+  return input;
+}
+
+Wire& makeFanOut(Network& network, int size)
+{
+  Wire& input = network.make("Input", 1);
+  for (int i = 0; i < size; ++i)
+  {
+    input <= LIMIT + i;
+  }
+  return input;
+}
+
+Wire& makeMixed(Network& network, int size)
+{
+  // Each parameter adds two bounds, a product and a term of the total
+  const int count = size / 4 > 1 ? size / 4 : 2;
+  std::vector<Wire*> parameters;
+  for (int i = 0; i < count; ++i)
+  {
+    Wire& parameter = network.make(1 + i % 10);
+    0 <= parameter;
+    parameter <= 100;
+    parameters.push_back(&parameter);
+  }
+  Wire* total = &network.make(0);
+  for (int i = 0; i < count; ++i)
+  {
+    total = &(*total + *parameters[i] * *parameters[(i + 1) % count]);
+  }
+  *total <= LIMIT;
+  return *parameters.front();
+}
+
+}}
@@ -0,0 +1,31 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "Network.h"
+
+namespace common { namespace constraints {
+
+/** Builds a synthetic network of roughly the given number of operations.
+    \return the wire whose value drives the network
+ */
+typedef Wire& (*Generator)(Network& network, int size);
+
+/** A chain of additions ending in a relation. */
+Wire& makeChain(Network& network, int size);
+/** A chain of additions with a relation on every wire. */
+Wire& makeConstrainedChain(Network& network, int size);
+/** A balanced tree of additions summing size wires. */
+Wire& makeSumTree(Network& network, int size);
+/** A lattice eight wires wide, where each wire averages two neighbours of
+    the level above, so every change reaches many operations through many
+    paths.
+ */
+Wire& makeDiamondLattice(Network& network, int size);
+/** A single wire taking part in size relations. */
+Wire& makeFanOut(Network& network, int size);
+/** Parameters with bounds, pairwise products and a total, shaped like a
+    configuration check.
+ */
+Wire& makeMixed(Network& network, int size);
+
+}}
@@ -0,0 +1,156 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "AllocationCounter.h"
+#include "Generators.h"
+
+#include "Exporter.h"
+#include "Network.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace common { namespace constraints {
+
+namespace {
+
+/** Reports the allocations per iteration and the peak heap usage of a
+    benchmark, measured from its construction.
+ */
+class MemoryReport
+{
+public:
+  MemoryReport()
+    : mAllocations(AllocationCounter::getAllocations())
+    , mBaseBytes(AllocationCounter::getLiveBytes())
+  {
+    AllocationCounter::resetPeak();
+  }
+
+  void report(benchmark::State& state) const
+  {
+    state.counters["allocs/op"] = benchmark::Counter(
+      static_cast<double>(AllocationCounter::getAllocations() - mAllocations),
+      benchmark::Counter::kAvgIterations);
+    state.counters["peak_bytes"] = static_cast<double>(
+      AllocationCounter::getPeakBytes() - mBaseBytes);
+  }
+
+private:
+  std::size_t mAllocations;
+  std::size_t mBaseBytes;
+};
+
+void BM_Construct(benchmark::State& state, Generator generate)
+{
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    Network network;
+    benchmark::DoNotOptimize(&generate(network, state.range(0)));
+  }
+  memory.report(state);
+}
+
+void BM_Set(benchmark::State& state, Generator generate)
+{
+  Network network;
+  Wire& input = generate(network, state.range(0));
+  double value = 1;
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    value = 3 - value;
+    benchmark::DoNotOptimize(static_cast<bool>(input.set(value)));
+  }
+  memory.report(state);
+}
+
+void BM_Range(benchmark::State& state, Generator generate)
+{
+  Network network;
+  Wire& input = generate(network, state.range(0));
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(input.range());
+  }
+  memory.report(state);
+}
+
+void BM_AllRanges(benchmark::State& state, Generator generate)
+{
+  Network network;
+  generate(network, state.range(0));
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(network.computeAllRanges().size());
+  }
+  memory.report(state);
+}
+
+void BM_Dump(benchmark::State& state, Generator generate)
+{
+  Network network;
+  Wire& input = generate(network, state.range(0));
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    std::string dump = input.dump();
+    benchmark::DoNotOptimize(dump.data());
+  }
+  memory.report(state);
+}
+
+void BM_Export(benchmark::State& state, Generator generate)
+{
+  Network network;
+  generate(network, state.range(0));
+  MemoryReport memory;
+  for (auto _ : state)
+  {
+    std::ostringstream s;
+    Exporter(network).write(s, Exporter::JSON);
+    benchmark::DoNotOptimize(s.tellp());
+  }
+  memory.report(state);
+}
+
+}
+
+/** Registers the benchmarks of a network shape. Range queries and dumps
+    visit every path through the network, so their sizes are limited
+    separately. Exports and computing all ranges at once take time linear in
+    the size of the network.
+ */
+#define CONSTRAINTS_BENCHMARK_SHAPE(name, generator, maxQuerySize)            \
+  BENCHMARK_CAPTURE(BM_Construct, name, generator)                            \
+    ->RangeMultiplier(8)                                                      \
+    ->Range(64, 32768);                                                       \
+  BENCHMARK_CAPTURE(BM_Set, name, generator)                                  \
+    ->RangeMultiplier(8)                                                      \
+    ->Range(64, 32768);                                                       \
+  BENCHMARK_CAPTURE(BM_Range, name, generator)                                \
+    ->RangeMultiplier(8)                                                      \
+    ->Range(64, maxQuerySize);                                                \
+  BENCHMARK_CAPTURE(BM_Export, name, generator)                               \
+    ->RangeMultiplier(8)                                                      \
+    ->Range(64, 32768);                                                       \
+  BENCHMARK_CAPTURE(BM_AllRanges, name, generator)                            \
+    ->RangeMultiplier(8)                                                      \
+    ->Range(64, 32768);                                                       \
+  BENCHMARK_CAPTURE(BM_Dump, name, generator)->RangeMultiplier(4)->Range(16, 64)
+
+CONSTRAINTS_BENCHMARK_SHAPE(chain, &makeChain, 4096);
+CONSTRAINTS_BENCHMARK_SHAPE(constrainedChain, &makeConstrainedChain, 4096);
+CONSTRAINTS_BENCHMARK_SHAPE(sumTree, &makeSumTree, 4096);
+CONSTRAINTS_BENCHMARK_SHAPE(diamondLattice, &makeDiamondLattice, 128);
+CONSTRAINTS_BENCHMARK_SHAPE(fanOut, &makeFanOut, 4096);
+CONSTRAINTS_BENCHMARK_SHAPE(mixed, &makeMixed, 4096);
+
+}}
+
+BENCHMARK_MAIN();
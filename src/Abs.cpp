@@ -0,0 +1,99 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Abs.h"
+
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <assert.h>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Abs::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  s << mAbsolute.dump(indentationLevel + 1);
+  return s.str();
+}
+
+std::string Abs::getShortDescription() const
+{
+  std::ostringstream name;
+  name << "abs(" << mInput.getShortDescription() << ")";
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Abs::Abs(IWire& input, IWire& absolute)
+  : mInput(input)
+  , mAbsolute(absolute)
+{
+  connect(mInput);
+  drive(mAbsolute);
+  bool valid = propagateValue();
+  if (getNetwork(mInput).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Abs::propagateValue()
+{
+  // The chain of operations is added by the network if propagation fails
+  const Value value = mInput.get();
+  return mAbsolute.set(value < 0 ? -value : value);
+}
+
+Range Abs::range(const IWire& varyingWire) const
+{
+  // The relations downstream restrict the absolute value. Its expression
+  // keeps the varying wire on the side of zero the input is on.
+  return mAbsolute.range(varyingWire);
+}
+
+std::string Abs::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail because ";
+  return s.str();
+}
+
+WireExpression Abs::expression(const IWire& varyingWire) const
+{
+  // Linear on the side of zero the input is currently on, as long as it stays
+  // there. If that cannot be solved, only the current value is known.
+  const WireExpression zero = WireExpression::createLinear(0, 0);
+  const WireExpression input = mInput.expression(varyingWire);
+  const bool negative = mInput.get() < 0;
+  WireExpression absolute = negative ? zero - input : input;
+  absolute.domain = input.nonlinear
+                      ? Range(varyingWire.get(), varyingWire.get())
+                      : negative ? LessOrEqual::solveInequality(input, zero)
+                                 : LessOrEqual::solveInequality(zero, input);
+  return absolute;
+}
+
+void Abs::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::ABS, mInput, mInput, &mAbsolute);
+}
+
+void Abs::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mInput);
+}
+
+void Abs::writeName(NameWriter& name) const
+{
+  name.text("abs(");
+  name.wire(mInput);
+  name.text(")");
+}
+
+}}
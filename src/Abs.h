@@ -0,0 +1,46 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "IOperation.h"
+#include "IWire.h"
+
+namespace common { namespace constraints {
+
+/** Models the absolute value of a wire.
+
+    The expression of the output is the expression of the input, negated if
+    the input is currently negative, so a range derived through it holds as
+    long as the input keeps its sign.
+ */
+class Abs : public IOperation
+{
+public:
+  virtual ~Abs(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+private:
+  Abs(const Abs&) = delete;
+  void operator=(const Abs&) = delete;
+  Abs(IWire& input, IWire& absolute);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& wire) const override;
+  virtual WireExpression expression(const IWire& variable) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
+private:
+  IWire& mInput;
+  IWire& mAbsolute;
+
+  // Allow network factory functions to create absolute value objects
+  friend class Network;
+  friend class AbsTest;
+};
+
+}}
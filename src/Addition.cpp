@@ -26,13 +26,6 @@ std::string Addition::getShortDescription() const
   return name.str();
 }
 
-std::string Addition::getName() const
-{
-  std::ostringstream name;
-  name << mTermA.getName() << " + " << mTermB.getName();
-  return name.str();
-}
-
 // ----------------------------------------------------------------------------
 // Private functions
 
@@ -53,9 +46,8 @@ Addition::Addition(IWire& termA, IWire& termB, IWire& sum)
 
 Result Addition::propagateValue()
 {
-  Result r = mSum.set(mTermA.get() + mTermB.get());
-  r.push(this);
-  return r;
+  // The chain of operations is added by the network if propagation fails
+  return mSum.set(mTermA.get() + mTermB.get());
 }
 
 Range Addition::range(const IWire& varyingWire) const
@@ -76,4 +68,22 @@ WireExpression Addition::expression(const IWire& varyingWire) const
   return mTermA.expression(varyingWire) + mTermB.expression(varyingWire);
 }
 
+void Addition::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::ADD, mTermA, mTermB, &mSum);
+}
+
+void Addition::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mTermA);
+  inputs.push_back(&mTermB);
+}
+
+void Addition::writeName(NameWriter& name) const
+{
+  name.wire(mTermA);
+  name.text(" + ");
+  name.wire(mTermB);
+}
+
 }}
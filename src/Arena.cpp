@@ -0,0 +1,103 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const std::size_t FIRST_BLOCK_SIZE = 4096;
+const std::size_t MAX_BLOCK_SIZE = 1024 * 1024;
+const std::size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+namespace common { namespace constraints {
+
+Arena::Arena(MemoryResource& upstream)
+  : mUpstream(upstream)
+  , mBlocks(nullptr)
+  , mCurrent(nullptr)
+  , mEnd(nullptr)
+  , mNextBlockSize(FIRST_BLOCK_SIZE)
+  , mReservedBytes(0)
+  , mUsedBytes(0)
+{
+}
+
+Arena::Arena(void* buffer, std::size_t size, MemoryResource& upstream)
+  : mUpstream(upstream)
+  , mBlocks(nullptr)
+  , mCurrent(static_cast<char*>(buffer))
+  , mEnd(static_cast<char*>(buffer) + size)
+  , mNextBlockSize(FIRST_BLOCK_SIZE)
+  , mReservedBytes(size)
+  , mUsedBytes(0)
+{
+}
+
+Arena::~Arena()
+{
+  while (mBlocks != nullptr)
+  {
+    Block* previous = mBlocks->previous;
+    mUpstream.deallocate(mBlocks, mBlocks->size, BLOCK_ALIGNMENT);
+    mBlocks = previous;
+  }
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+  std::uintptr_t current = reinterpret_cast<std::uintptr_t>(mCurrent);
+  std::uintptr_t aligned = alignUp(current, alignment);
+  if (mCurrent == nullptr
+      || aligned + bytes > reinterpret_cast<std::uintptr_t>(mEnd))
+  {
+    // Start a new block, large enough for oversized requests
+    const std::size_t header = alignUp(sizeof(Block), BLOCK_ALIGNMENT);
+    const std::size_t size =
+      std::max(mNextBlockSize, header + alignUp(bytes, alignment) + alignment);
+    void* memory = mUpstream.allocate(size, BLOCK_ALIGNMENT);
+    if (memory == nullptr)
+    {
+      return nullptr;
+    }
+    Block* block = static_cast<Block*>(memory);
+    block->previous = mBlocks;
+    block->size = size;
+    mBlocks = block;
+    mCurrent = static_cast<char*>(memory) + header;
+    mEnd = static_cast<char*>(memory) + size;
+    mReservedBytes += size;
+    mNextBlockSize = std::min(mNextBlockSize * 2, MAX_BLOCK_SIZE);
+
+    current = reinterpret_cast<std::uintptr_t>(mCurrent);
+    aligned = alignUp(current, alignment);
+  }
+  mCurrent += (aligned - current) + bytes;
+  mUsedBytes += (aligned - current) + bytes;
+  return reinterpret_cast<void*>(aligned);
+}
+
+std::size_t Arena::getReservedBytes() const
+{
+  return mReservedBytes;
+}
+
+std::size_t Arena::getUsedBytes() const
+{
+  return mUsedBytes;
+}
+
+std::size_t Arena::getAvailableBytes() const
+{
+  return static_cast<std::size_t>(mEnd - mCurrent);
+}
+
+}}
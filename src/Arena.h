@@ -0,0 +1,115 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "MemoryResource.h"
+
+#include <assert.h>
+#include <cstddef>
+
+namespace common { namespace constraints {
+
+/** Monotonic allocator handing out memory from large blocks.
+
+    Memory is obtained from an upstream MemoryResource in blocks of growing
+    size and carved out by bumping a pointer. Individual allocations are never
+    freed; all blocks are returned to the upstream resource at once when the
+    arena is destroyed. Objects placed in the arena must be destroyed by their
+    owner before that.
+ */
+class Arena
+{
+public:
+  explicit Arena(MemoryResource& upstream = MemoryResource::getDefault());
+  /** Creates an arena that first hands out memory from the given buffer, and
+      only asks the upstream resource for more when the buffer is full. The
+      buffer must outlive the arena.
+   */
+  Arena(void* buffer, std::size_t size, MemoryResource& upstream);
+  ~Arena();
+
+  /** Allocates memory with the given size and alignment.
+      \return the memory, or null if the upstream resource is exhausted
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment);
+
+  /** Gets the number of bytes in the initial buffer and those obtained from
+      the upstream resource.
+   */
+  std::size_t getReservedBytes() const;
+  /** Gets the number of bytes handed out so far, including alignment. */
+  std::size_t getUsedBytes() const;
+  /** Gets the number of bytes left in the current block, which can be
+      handed out without asking the upstream resource.
+   */
+  std::size_t getAvailableBytes() const;
+
+private:
+  Arena(const Arena&) = delete;
+  void operator=(const Arena&) = delete;
+
+  /** Header at the start of every block. */
+  struct Block
+  {
+    Block* previous;
+    std::size_t size;
+  };
+
+private:
+  MemoryResource& mUpstream;
+  Block* mBlocks;
+  char* mCurrent;
+  char* mEnd;
+  std::size_t mNextBlockSize;
+  std::size_t mReservedBytes;
+  std::size_t mUsedBytes;
+};
+
+/** Standard allocator adapter for placing containers in an Arena.
+    Deallocation is a no-op; the memory is reclaimed with the arena.
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena& arena)
+    : mArena(&arena)
+  {
+  }
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other)
+    : mArena(other.mArena)
+  {
+  }
+
+  T* allocate(std::size_t count)
+  {
+    void* memory = mArena->allocate(count * sizeof(T), alignof(T));
+    assert(memory != nullptr);
+    return static_cast<T*>(memory);
+  }
+
+  void deallocate(T*, std::size_t) {}
+
+  template <class U>
+  bool operator==(const ArenaAllocator<U>& other) const
+  {
+    return mArena == other.mArena;
+  }
+
+  template <class U>
+  bool operator!=(const ArenaAllocator<U>& other) const
+  {
+    return mArena != other.mArena;
+  }
+
+private:
+  Arena* mArena;
+
+  template <class U>
+  friend class ArenaAllocator;
+};
+
+}}
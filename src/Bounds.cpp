@@ -0,0 +1,136 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Bounds.h"
+
+#include "IWire.h"
+#include "Network.h"
+
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Bounds::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  return s.str();
+}
+
+std::string Bounds::getShortDescription() const
+{
+  std::ostringstream name;
+  name << mLower << " <= " << mWire.getShortDescription() << " <= " << mUpper;
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Range Bounds::solve(WireExpression expression, Value lower, Value upper)
+{
+  if (expression.nonlinear)
+  {
+    std::stringstream message;
+    message << "Bounds cannot solve inequality with nonlinear expression: "
+            << lower << " <= " << expression << " <= " << upper;
+    std::cerr << message.str() << std::endl;
+    assert(false);
+  }
+  // The expression is of form k*x + m
+  const Value k = expression.firstDegree;
+  const Value m = expression.constant;
+
+  // Case I: k == 0: x can be any real number if the window holds for m,
+  // otherwise there are no solutions for x
+  if (k == 0)
+  {
+    return lower <= m && m <= upper ? expression.domain : Range::EMPTY;
+  }
+
+  // Case II: k != 0: x is between (lower - m)/k and (upper - m)/k, which
+  // trade places if k < 0. Infinite limits stay infinite. Either way the
+  // solution only holds where the expression holds.
+  const Value outward = k > 0 ? Range::POSITIVE_INFINITY
+                              : Range::NEGATIVE_INFINITY;
+  const Value fromLower =
+    lower == Range::NEGATIVE_INFINITY ? -outward : (lower - m) / k;
+  const Value fromUpper =
+    upper == Range::POSITIVE_INFINITY ? outward : (upper - m) / k;
+  return Range::intersect(k > 0 ? Range(fromLower, fromUpper)
+                                : Range(fromUpper, fromLower),
+                          expression.domain);
+}
+
+Bounds::Bounds(IWire& wire, Value lower, Value upper)
+  : mWire(wire)
+  , mLower(lower)
+  , mUpper(upper)
+{
+  connect(mWire);
+  bool valid = propagateValue();
+  if (getNetwork(mWire).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Bounds::propagateValue()
+{
+  const Value value = mWire.get();
+  Result r = Result(mLower <= value && value <= mUpper);
+  if (!r)
+  {
+    r.push(this);
+  }
+  return r;
+}
+
+Range Bounds::range(const IWire& varyingWire) const
+{
+  // Solve for the valid values of varyingWire
+  return solve(mWire.expression(varyingWire), mLower, mUpper);
+}
+
+std::string Bounds::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail";
+  return s.str();
+}
+
+WireExpression Bounds::expression(const IWire& varyingWire) const
+{
+  // Should never be called.
+  (void)varyingWire;
+  exit(1);
+}
+
+void Bounds::compile(CompiledNetwork& compiled) const
+{
+  compileBoundedAs(compiled,
+                   CompiledNetwork::BOUNDS,
+                   mWire,
+                   mWire,
+                   nullptr,
+                   static_cast<double>(mLower),
+                   static_cast<double>(mUpper));
+}
+
+void Bounds::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mWire);
+}
+
+void Bounds::writeName(NameWriter& name) const
+{
+  name.value(mLower);
+  name.text(" <= ");
+  name.wire(mWire);
+  name.text(" <= ");
+  name.value(mUpper);
+}
+
+}}
@@ -0,0 +1,54 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "IOperation.h"
+#include "IWire.h"
+
+namespace common { namespace constraints {
+
+/** Models a window relation lower <= x <= upper on one wire, with literal
+    limits. It is checked with one pair of comparisons and solved for a range
+    in one step, instead of as two LessOrEqual relations.
+ */
+class Bounds : public IOperation
+{
+public:
+  virtual ~Bounds(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+private:
+  Bounds(const Bounds&) = delete;
+  void operator=(const Bounds&) = delete;
+  Bounds(IWire& wire, Value lower, Value upper);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& varyingWire) const override;
+  virtual WireExpression expression(const IWire& varyingWire) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
+  /** Solve for x in lower <= a*x + b <= upper, where either limit may be
+      infinite.
+      \return the range of values of x that satisfy the inequalities and for
+      which the expression holds
+   */
+  static Range solve(WireExpression expression, Value lower, Value upper);
+
+private:
+  IWire& mWire;
+  Value mLower;
+  Value mUpper;
+
+  // Allow network factory functions to create window objects
+  friend class Network;
+  // Allow equality relations to be solved as a window on the difference
+  friend class Equal;
+  // Allow clamps to solve where the input stays between their limits
+  friend class Clamp;
+  friend class BoundsTest;
+};
+}}
@@ -0,0 +1,131 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Clamp.h"
+
+#include "Bounds.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <assert.h>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Clamp::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  s << mClamped.dump(indentationLevel + 1);
+  return s.str();
+}
+
+std::string Clamp::getShortDescription() const
+{
+  std::ostringstream name;
+  name << "clamp(" << mInput.getShortDescription() << ", " << mLower << ", "
+       << mUpper << ")";
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Clamp::Clamp(IWire& input, Value lower, Value upper, IWire& clamped)
+  : mInput(input)
+  , mLower(lower)
+  , mUpper(upper)
+  , mClamped(clamped)
+{
+  assert(!(upper < lower));
+  connect(mInput);
+  drive(mClamped);
+  bool valid = propagateValue();
+  if (getNetwork(mInput).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Clamp::propagateValue()
+{
+  // The chain of operations is added by the network if propagation fails
+  const Value value = mInput.get();
+  return mClamped.set(value < mLower ? mLower
+                                     : (mUpper < value ? mUpper : value));
+}
+
+Range Clamp::range(const IWire& varyingWire) const
+{
+  // The relations downstream restrict the clamped value. Its expression
+  // keeps the varying wire within the piece of the clamp that is active.
+  return mClamped.range(varyingWire);
+}
+
+std::string Clamp::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail because ";
+  return s.str();
+}
+
+WireExpression Clamp::expression(const IWire& varyingWire) const
+{
+  // Constant at a limit, otherwise linear in the input, as long as the input
+  // stays on the same side of the limits. If that cannot be solved, only the
+  // current value is known.
+  const WireExpression input = mInput.expression(varyingWire);
+  const WireExpression lower = WireExpression::createLinear(0, mLower);
+  const WireExpression upper = WireExpression::createLinear(0, mUpper);
+  const Value value = mInput.get();
+  WireExpression clamped = value < mLower   ? lower
+                           : mUpper < value ? upper
+                                            : input;
+  if (input.nonlinear)
+  {
+    clamped.domain = Range(varyingWire.get(), varyingWire.get());
+  }
+  else if (value < mLower)
+  {
+    clamped.domain = LessOrEqual::solveInequality(input, lower);
+  }
+  else if (mUpper < value)
+  {
+    clamped.domain = LessOrEqual::solveInequality(upper, input);
+  }
+  else
+  {
+    clamped.domain = Bounds::solve(input, mLower, mUpper);
+  }
+  return clamped;
+}
+
+void Clamp::compile(CompiledNetwork& compiled) const
+{
+  compileBoundedAs(compiled,
+                   CompiledNetwork::CLAMP,
+                   mInput,
+                   mInput,
+                   &mClamped,
+                   static_cast<double>(mLower),
+                   static_cast<double>(mUpper));
+}
+
+void Clamp::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mInput);
+}
+
+void Clamp::writeName(NameWriter& name) const
+{
+  name.text("clamp(");
+  name.wire(mInput);
+  name.text(", ");
+  name.value(mLower);
+  name.text(", ");
+  name.value(mUpper);
+  name.text(")");
+}
+
+}}
@@ -0,0 +1,48 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "IOperation.h"
+#include "IWire.h"
+
+namespace common { namespace constraints {
+
+/** Models a wire limited to the window [lower, upper] with literal limits.
+
+    The expression of the output is the expression of the input while it is
+    within the window, and constant otherwise, so a range derived through it
+    holds as long as the input stays on the same side of the limits.
+ */
+class Clamp : public IOperation
+{
+public:
+  virtual ~Clamp(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+private:
+  Clamp(const Clamp&) = delete;
+  void operator=(const Clamp&) = delete;
+  Clamp(IWire& input, Value lower, Value upper, IWire& clamped);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& wire) const override;
+  virtual WireExpression expression(const IWire& variable) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
+private:
+  IWire& mInput;
+  Value mLower;
+  Value mUpper;
+  IWire& mClamped;
+
+  // Allow network factory functions to create clamp objects
+  friend class Network;
+  friend class ClampTest;
+};
+
+}}
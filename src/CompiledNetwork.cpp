@@ -0,0 +1,836 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "CompiledNetwork.h"
+
+#include "IOperation.h"
+#include "IWire.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#endif
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#endif
+
+namespace {
+
+/** Number of scenarios evaluated in lockstep, one bit each in a mask word. */
+const std::size_t LANES = 64;
+
+/** Operations per chunk handed to a thread in parallel propagation. Levels
+    smaller than one chunk are evaluated on the calling thread.
+ */
+const std::size_t PARALLEL_CHUNK = 512;
+
+/** Returns the index of the lowest set bit of a non-zero word. */
+unsigned int lowestBit(std::uint64_t word)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return static_cast<unsigned int>(index);
+#else
+  return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+}
+
+// Kernels operating on LANES values at a time. The SIMD variants require no
+// particular alignment.
+
+void addLanes(const double* a, const double* b, double* out)
+{
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(out + i, _mm256_add_pd(va, vb));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vb = _mm_loadu_pd(b + i);
+    _mm_storeu_pd(out + i, _mm_add_pd(va, vb));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] + b[i];
+  }
+#endif
+}
+
+void multiplyLanes(const double* a, const double* b, double* out)
+{
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(va, vb));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vb = _mm_loadu_pd(b + i);
+    _mm_storeu_pd(out + i, _mm_mul_pd(va, vb));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] * b[i];
+  }
+#endif
+}
+
+void scaleAddLanes(const double* a, double k, double* out)
+{
+#if defined(__AVX__)
+  const __m256d vk = _mm256_set1_pd(k);
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vout = _mm256_loadu_pd(out + i);
+    _mm256_storeu_pd(out + i, _mm256_add_pd(vout, _mm256_mul_pd(va, vk)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128d vk = _mm_set1_pd(k);
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vout = _mm_loadu_pd(out + i);
+    _mm_storeu_pd(out + i, _mm_add_pd(vout, _mm_mul_pd(va, vk)));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] += a[i] * k;
+  }
+#endif
+}
+
+void subtractLanes(const double* a, const double* b, double* out)
+{
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(out + i, _mm256_sub_pd(va, vb));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vb = _mm_loadu_pd(b + i);
+    _mm_storeu_pd(out + i, _mm_sub_pd(va, vb));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] - b[i];
+  }
+#endif
+}
+
+// The minimum and maximum kernels select with an explicit ordered compare,
+// so they return b where a and b are unordered, and a where they are equal,
+// exactly like the scalar a <= b ? a : b and a >= b ? a : b.
+
+void minLanes(const double* a, const double* b, double* out)
+{
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(
+      out + i, _mm256_blendv_pd(vb, va, _mm256_cmp_pd(va, vb, _CMP_LE_OQ)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vb = _mm_loadu_pd(b + i);
+    const __m128d le = _mm_cmple_pd(va, vb);
+    _mm_storeu_pd(out + i,
+                  _mm_or_pd(_mm_and_pd(le, va), _mm_andnot_pd(le, vb)));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] <= b[i] ? a[i] : b[i];
+  }
+#endif
+}
+
+void maxLanes(const double* a, const double* b, double* out)
+{
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(
+      out + i, _mm256_blendv_pd(vb, va, _mm256_cmp_pd(va, vb, _CMP_GE_OQ)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d vb = _mm_loadu_pd(b + i);
+    const __m128d ge = _mm_cmpge_pd(va, vb);
+    _mm_storeu_pd(out + i,
+                  _mm_or_pd(_mm_and_pd(ge, va), _mm_andnot_pd(ge, vb)));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] >= b[i] ? a[i] : b[i];
+  }
+#endif
+}
+
+void absLanes(const double* a, double* out)
+{
+#if defined(__AVX__)
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    _mm256_storeu_pd(out + i, _mm256_andnot_pd(sign, _mm256_loadu_pd(a + i)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128d sign = _mm_set1_pd(-0.0);
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    _mm_storeu_pd(out + i, _mm_andnot_pd(sign, _mm_loadu_pd(a + i)));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] < 0 ? -a[i] : a[i];
+  }
+#endif
+}
+
+// The SIMD minimum and maximum return their second operand unless the first
+// is strictly smaller or larger, so with the input second, the clamp keeps
+// NaN and the sign of zero like the scalar
+// a < lower ? lower : (upper < a ? upper : a).
+void clampLanes(const double* a, double lower, double upper, double* out)
+{
+#if defined(__AVX__)
+  const __m256d vlower = _mm256_set1_pd(lower);
+  const __m256d vupper = _mm256_set1_pd(upper);
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    _mm256_storeu_pd(out + i,
+                     _mm256_min_pd(vupper, _mm256_max_pd(vlower, va)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128d vlower = _mm_set1_pd(lower);
+  const __m128d vupper = _mm_set1_pd(upper);
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    _mm_storeu_pd(out + i, _mm_min_pd(vupper, _mm_max_pd(vlower, va)));
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    out[i] = a[i] < lower ? lower : (upper < a[i] ? upper : a[i]);
+  }
+#endif
+}
+
+/** \return a mask with one bit set per lane where a <= b */
+std::uint64_t lessOrEqualLanes(const double* a, const double* b)
+{
+  std::uint64_t mask = 0;
+#if defined(__AVX__)
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d le =
+      _mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_LE_OQ);
+    mask |= std::uint64_t(_mm256_movemask_pd(le)) << i;
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d le = _mm_cmple_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+    mask |= std::uint64_t(_mm_movemask_pd(le)) << i;
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    mask |= std::uint64_t(a[i] <= b[i]) << i;
+  }
+#endif
+  return mask;
+}
+
+/** \return a mask with one bit set per lane where lower <= a <= upper */
+std::uint64_t withinLanes(const double* a, double lower, double upper)
+{
+  std::uint64_t mask = 0;
+#if defined(__AVX__)
+  const __m256d vlower = _mm256_set1_pd(lower);
+  const __m256d vupper = _mm256_set1_pd(upper);
+  for (std::size_t i = 0; i < LANES; i += 4)
+  {
+    const __m256d va = _mm256_loadu_pd(a + i);
+    const __m256d within = _mm256_and_pd(_mm256_cmp_pd(vlower, va, _CMP_LE_OQ),
+                                         _mm256_cmp_pd(va, vupper, _CMP_LE_OQ));
+    mask |= std::uint64_t(_mm256_movemask_pd(within)) << i;
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128d vlower = _mm_set1_pd(lower);
+  const __m128d vupper = _mm_set1_pd(upper);
+  for (std::size_t i = 0; i < LANES; i += 2)
+  {
+    const __m128d va = _mm_loadu_pd(a + i);
+    const __m128d within =
+      _mm_and_pd(_mm_cmple_pd(vlower, va), _mm_cmple_pd(va, vupper));
+    mask |= std::uint64_t(_mm_movemask_pd(within)) << i;
+  }
+#else
+  for (std::size_t i = 0; i < LANES; ++i)
+  {
+    mask |= std::uint64_t(lower <= a[i] && a[i] <= upper) << i;
+  }
+#endif
+  return mask;
+}
+
+}
+
+namespace common { namespace constraints {
+
+bool CompiledNetwork::BatchResult::hasPassed(std::size_t scenario) const
+{
+  return (passed[scenario / 64] >> (scenario % 64)) & 1;
+}
+
+const CompiledNetwork::Index CompiledNetwork::NONE =
+  std::numeric_limits<CompiledNetwork::Index>::max();
+
+CompiledNetwork::Index CompiledNetwork::indexOf(const IWire& wire) const
+{
+  auto it = mIndices.find(&wire);
+  assert(it != mIndices.end());
+  return it->second;
+}
+
+std::size_t CompiledNetwork::getWireCount() const
+{
+  return mValues.size();
+}
+
+std::size_t CompiledNetwork::getOperationCount() const
+{
+  return mOpcodes.size();
+}
+
+double CompiledNetwork::get(Index wire) const
+{
+  return mValues[wire];
+}
+
+Result CompiledNetwork::set(Index wire, double value)
+{
+  mValues[wire] = value;
+  scheduleConsumers(wire, NONE);
+
+  // Consumers always come later in the tape, so operations scheduled while
+  // scanning are never behind the scan position.
+  const std::size_t firstWord =
+    mConsumerOffsets[wire] < mConsumerOffsets[wire + 1]
+      ? mConsumers[mConsumerOffsets[wire]] / 64
+      : mScheduled.size();
+  for (std::size_t word = firstWord; word < mScheduled.size(); ++word)
+  {
+    while (mScheduled[word] != 0)
+    {
+      const Index operation =
+        static_cast<Index>(word * 64 + lowestBit(mScheduled[word]));
+      mScheduled[word] &= mScheduled[word] - 1;
+      if (!evaluate(operation))
+      {
+        std::fill(mScheduled.begin() + word, mScheduled.end(), 0);
+        return failure(operation);
+      }
+      if (mOutputs[operation] != NONE)
+      {
+        scheduleConsumers(mOutputs[operation], operation);
+      }
+    }
+  }
+  return Result(true);
+}
+
+Result CompiledNetwork::set(Index wire, double value, ThreadPool& pool)
+{
+  mValues[wire] = value;
+  if (++mEpoch == 0)
+  {
+    std::fill(mChangedEpochs.begin(), mChangedEpochs.end(), 0);
+    mEpoch = 1;
+  }
+  mChangedEpochs[wire] = mEpoch;
+  mAssigned = wire;
+
+  if (mConsumerOffsets[wire] == mConsumerOffsets[wire + 1])
+  {
+    return Result(true);
+  }
+  const Index firstConsumer = mConsumers[mConsumerOffsets[wire]];
+  std::size_t level = static_cast<std::size_t>(
+    std::upper_bound(
+      mLevelOffsets.begin(), mLevelOffsets.end(), firstConsumer)
+    - mLevelOffsets.begin() - 1);
+
+  // Each level only reads values written by lower levels, so its operations
+  // can be evaluated in any order. Stopping at the lowest failing relation
+  // and undoing the writes behind it in its level gives the same values as
+  // sequential evaluation.
+  for (; level + 1 < mLevelOffsets.size(); ++level)
+  {
+    const Index begin = mLevelOffsets[level];
+    const Index end = mLevelOffsets[level + 1];
+    Index failed = NONE;
+    if (end - begin <= PARALLEL_CHUNK)
+    {
+      failed = evaluateChanged(begin, end);
+    }
+    else
+    {
+      std::atomic<Index> lowestFailed(NONE);
+      pool.parallelFor(
+        end - begin, PARALLEL_CHUNK, [&](std::size_t first, std::size_t last) {
+          Index chunkFailed = evaluateChanged(static_cast<Index>(begin + first),
+                                              static_cast<Index>(begin + last));
+          Index current = lowestFailed.load();
+          while (chunkFailed < current
+                 && !lowestFailed.compare_exchange_weak(current, chunkFailed))
+          {
+          }
+        });
+      failed = lowestFailed.load();
+    }
+    if (failed != NONE)
+    {
+      for (Index operation = failed + 1; operation < end; ++operation)
+      {
+        const Index output = mOutputs[operation];
+        if (output != NONE && mChangedEpochs[output] == mEpoch)
+        {
+          mValues[output] = mPreviousOutputs[operation];
+        }
+      }
+      return failure(failed);
+    }
+  }
+  return Result(true);
+}
+
+Result CompiledNetwork::verify()
+{
+  for (Index operation = 0; operation < mOpcodes.size(); ++operation)
+  {
+    if (!evaluate(operation))
+    {
+      Result result(false);
+      result.push(mSources[operation]);
+      return result;
+    }
+  }
+  return Result(true);
+}
+
+CompiledNetwork::BatchResult
+CompiledNetwork::evaluateBatch(const std::vector<Index>& inputs,
+                               const std::vector<const double*>& columns,
+                               std::size_t scenarioCount) const
+{
+  assert(inputs.size() == columns.size());
+
+  BatchResult result;
+  result.passed.assign((scenarioCount + 63) / 64, 0);
+  result.firstFailure.assign(scenarioCount, NONE);
+
+  // Values of all wires for one block of scenarios, LANES values per wire
+  std::vector<double> lanes(mValues.size() * LANES);
+  double difference[LANES];
+  for (std::size_t first = 0; first < scenarioCount; first += LANES)
+  {
+    const std::size_t count = std::min(LANES, scenarioCount - first);
+    for (std::size_t wire = 0; wire < mValues.size(); ++wire)
+    {
+      std::fill_n(&lanes[wire * LANES], LANES, mValues[wire]);
+    }
+    for (std::size_t input = 0; input < inputs.size(); ++input)
+    {
+      std::copy_n(columns[input] + first, count, &lanes[inputs[input] * LANES]);
+    }
+
+    // Unused lanes of the last block hold the current values; they are masked
+    // out below.
+    std::uint64_t passed = count == LANES ? ~std::uint64_t(0)
+                                          : (std::uint64_t(1) << count) - 1;
+    for (Index operation = 0; operation < mOpcodes.size(); ++operation)
+    {
+      const double* a = &lanes[mOperandsA[operation] * LANES];
+      const double* b = &lanes[mOperandsB[operation] * LANES];
+      switch (mOpcodes[operation])
+      {
+      case ADD:
+        addLanes(a, b, &lanes[mOutputs[operation] * LANES]);
+        break;
+      case MULTIPLY:
+        multiplyLanes(a, b, &lanes[mOutputs[operation] * LANES]);
+        break;
+      case LINEAR:
+      {
+        double* out = &lanes[mOutputs[operation] * LANES];
+        std::fill_n(out, LANES, mConstants[operation]);
+        for (Index term = mTermOffsets[operation];
+             term < mTermOffsets[operation + 1];
+             ++term)
+        {
+          scaleAddLanes(
+            &lanes[mTermWires[term] * LANES], mTermCoefficients[term], out);
+        }
+        break;
+      }
+      case MIN:
+        minLanes(a, b, &lanes[mOutputs[operation] * LANES]);
+        break;
+      case MAX:
+        maxLanes(a, b, &lanes[mOutputs[operation] * LANES]);
+        break;
+      case ABS:
+        absLanes(a, &lanes[mOutputs[operation] * LANES]);
+        break;
+      case CLAMP:
+        clampLanes(a,
+                   mLowerLimits[operation],
+                   mUpperLimits[operation],
+                   &lanes[mOutputs[operation] * LANES]);
+        break;
+      case BOUNDS:
+      case EQUAL:
+      {
+        const double* values = a;
+        if (mOpcodes[operation] == EQUAL)
+        {
+          subtractLanes(b, a, difference);
+          values = difference;
+        }
+        std::uint64_t failed = passed & ~withinLanes(values,
+                                                      mLowerLimits[operation],
+                                                      mUpperLimits[operation]);
+        passed &= ~failed;
+        for (; failed != 0; failed &= failed - 1)
+        {
+          result.firstFailure[first + lowestBit(failed)] = operation;
+        }
+        break;
+      }
+      case LESS_OR_EQUAL:
+      {
+        std::uint64_t failed = passed & ~lessOrEqualLanes(a, b);
+        passed &= ~failed;
+        for (; failed != 0; failed &= failed - 1)
+        {
+          result.firstFailure[first + lowestBit(failed)] = operation;
+        }
+        break;
+      }
+      }
+    }
+    result.passed[first / 64] = passed;
+  }
+  return result;
+}
+
+std::string CompiledNetwork::getOperationName(Index operation) const
+{
+  return mSources[operation]->getName();
+}
+
+// ----------------------------------------------------------------------------
+// Private members
+
+void CompiledNetwork::addWire(const IWire& wire)
+{
+  mIndices.emplace(&wire, static_cast<Index>(mValues.size()));
+  mValues.push_back(static_cast<double>(wire.get()));
+}
+
+void CompiledNetwork::addOperation(const IOperation& source,
+                                   unsigned int rank,
+                                   Opcode opcode,
+                                   const IWire& operandA,
+                                   const IWire& operandB,
+                                   const IWire* output)
+{
+  if (mOpcodes.empty() || rank != mLastRank)
+  {
+    mLevelOffsets.push_back(static_cast<Index>(mOpcodes.size()));
+    mLastRank = rank;
+  }
+  mOpcodes.push_back(opcode);
+  mOperandsA.push_back(indexOf(operandA));
+  mOperandsB.push_back(indexOf(operandB));
+  mOutputs.push_back(output != nullptr ? indexOf(*output) : NONE);
+  mSources.push_back(&source);
+  mTermOffsets.push_back(static_cast<Index>(mTermWires.size()));
+  mConstants.push_back(0);
+  mLowerLimits.push_back(0);
+  mUpperLimits.push_back(0);
+}
+
+void CompiledNetwork::addLinearOperation(
+  const IOperation& source,
+  unsigned int rank,
+  const std::vector<std::pair<const IWire*, double>>& terms,
+  double constant,
+  const IWire& output)
+{
+  assert(!terms.empty());
+  // The operands are only read for the bookkeeping shared with other
+  // operations, so they refer to the first term
+  addOperation(source,
+               rank,
+               LINEAR,
+               *terms.front().first,
+               *terms.front().first,
+               &output);
+  for (auto& term : terms)
+  {
+    mTermWires.push_back(indexOf(*term.first));
+    mTermCoefficients.push_back(term.second);
+  }
+  mTermOffsets.back() = static_cast<Index>(mTermWires.size());
+  mConstants.back() = constant;
+}
+
+void CompiledNetwork::addBoundedOperation(const IOperation& source,
+                                          unsigned int rank,
+                                          Opcode opcode,
+                                          const IWire& operandA,
+                                          const IWire& operandB,
+                                          const IWire* output,
+                                          double lower,
+                                          double upper)
+{
+  addOperation(source, rank, opcode, operandA, operandB, output);
+  mLowerLimits.back() = lower;
+  mUpperLimits.back() = upper;
+}
+
+void CompiledNetwork::finish()
+{
+  mLevelOffsets.push_back(static_cast<Index>(mOpcodes.size()));
+  mDrivers.assign(mValues.size(), NONE);
+  for (Index operation = 0; operation < mOpcodes.size(); ++operation)
+  {
+    if (mOutputs[operation] != NONE)
+    {
+      mDrivers[mOutputs[operation]] = operation;
+    }
+  }
+
+  // Count the consumers of each wire, then fill the rows in tape order. An
+  // operation using the same wire twice is only listed once.
+  mConsumerOffsets.assign(mValues.size() + 1, 0);
+  for (Index operation = 0; operation < mOpcodes.size(); ++operation)
+  {
+    if (mOpcodes[operation] == LINEAR)
+    {
+      for (Index term = mTermOffsets[operation];
+           term < mTermOffsets[operation + 1];
+           ++term)
+      {
+        ++mConsumerOffsets[mTermWires[term] + 1];
+      }
+      continue;
+    }
+    ++mConsumerOffsets[mOperandsA[operation] + 1];
+    if (mOperandsB[operation] != mOperandsA[operation])
+    {
+      ++mConsumerOffsets[mOperandsB[operation] + 1];
+    }
+  }
+  for (std::size_t wire = 0; wire < mValues.size(); ++wire)
+  {
+    mConsumerOffsets[wire + 1] += mConsumerOffsets[wire];
+  }
+  mConsumers.resize(mConsumerOffsets.back());
+  std::vector<Index> fill(mConsumerOffsets.begin(), mConsumerOffsets.end() - 1);
+  for (Index operation = 0; operation < mOpcodes.size(); ++operation)
+  {
+    if (mOpcodes[operation] == LINEAR)
+    {
+      for (Index term = mTermOffsets[operation];
+           term < mTermOffsets[operation + 1];
+           ++term)
+      {
+        mConsumers[fill[mTermWires[term]]++] = operation;
+      }
+      continue;
+    }
+    mConsumers[fill[mOperandsA[operation]]++] = operation;
+    if (mOperandsB[operation] != mOperandsA[operation])
+    {
+      mConsumers[fill[mOperandsB[operation]]++] = operation;
+    }
+  }
+
+  mScheduled.assign((mOpcodes.size() + 63) / 64, 0);
+  mScheduledBy.assign(mOpcodes.size(), NONE);
+  mChangedEpochs.assign(mValues.size(), 0);
+  mPreviousOutputs.assign(mOpcodes.size(), 0);
+}
+
+bool CompiledNetwork::evaluate(Index operation)
+{
+  const double a = mValues[mOperandsA[operation]];
+  const double b = mValues[mOperandsB[operation]];
+  switch (mOpcodes[operation])
+  {
+  case ADD:
+    mValues[mOutputs[operation]] = a + b;
+    return true;
+  case MULTIPLY:
+    mValues[mOutputs[operation]] = a * b;
+    return true;
+  case LESS_OR_EQUAL:
+    return a <= b;
+  case MIN:
+    mValues[mOutputs[operation]] = a <= b ? a : b;
+    return true;
+  case MAX:
+    mValues[mOutputs[operation]] = a >= b ? a : b;
+    return true;
+  case ABS:
+    mValues[mOutputs[operation]] = a < 0 ? -a : a;
+    return true;
+  case CLAMP:
+    mValues[mOutputs[operation]] =
+      a < mLowerLimits[operation]
+        ? mLowerLimits[operation]
+        : (mUpperLimits[operation] < a ? mUpperLimits[operation] : a);
+    return true;
+  case BOUNDS:
+    return mLowerLimits[operation] <= a && a <= mUpperLimits[operation];
+  case EQUAL:
+    return mLowerLimits[operation] <= b - a && b - a <= mUpperLimits[operation];
+  case LINEAR:
+  {
+    double sum = mConstants[operation];
+    for (Index term = mTermOffsets[operation];
+         term < mTermOffsets[operation + 1];
+         ++term)
+    {
+      sum += mTermCoefficients[term] * mValues[mTermWires[term]];
+    }
+    mValues[mOutputs[operation]] = sum;
+    return true;
+  }
+  }
+  return true;
+}
+
+void CompiledNetwork::scheduleConsumers(Index wire, Index scheduledBy)
+{
+  const Index end = mConsumerOffsets[wire + 1];
+  for (Index i = mConsumerOffsets[wire]; i < end; ++i)
+  {
+    const Index operation = mConsumers[i];
+    const std::uint64_t bit = std::uint64_t(1) << (operation % 64);
+    if ((mScheduled[operation / 64] & bit) == 0)
+    {
+      mScheduled[operation / 64] |= bit;
+      mScheduledBy[operation] = scheduledBy;
+    }
+  }
+}
+
+CompiledNetwork::Index CompiledNetwork::evaluateChanged(Index begin, Index end)
+{
+  for (Index operation = begin; operation < end; ++operation)
+  {
+    // Sequential evaluation records whichever changed operand was written
+    // first: the assigned wire, even if it is driven, or else the one whose
+    // driver comes first in the tape.
+    bool changed = false;
+    Index scheduledBy = NONE;
+    bool changedInput = false;
+    auto visit = [&](Index operand) {
+      if (mChangedEpochs[operand] == mEpoch)
+      {
+        changed = true;
+        changedInput |= operand == mAssigned;
+        scheduledBy = std::min(scheduledBy, mDrivers[operand]);
+      }
+    };
+    if (mOpcodes[operation] == LINEAR)
+    {
+      for (Index term = mTermOffsets[operation];
+           term < mTermOffsets[operation + 1];
+           ++term)
+      {
+        visit(mTermWires[term]);
+      }
+    }
+    else
+    {
+      visit(mOperandsA[operation]);
+      visit(mOperandsB[operation]);
+    }
+    if (!changed)
+    {
+      continue;
+    }
+    mScheduledBy[operation] = changedInput ? NONE : scheduledBy;
+
+    const Index output = mOutputs[operation];
+    if (output != NONE)
+    {
+      mPreviousOutputs[operation] = mValues[output];
+    }
+    if (!evaluate(operation))
+    {
+      return operation;
+    }
+    if (output != NONE)
+    {
+      mChangedEpochs[output] = mEpoch;
+    }
+  }
+  return NONE;
+}
+
+Result CompiledNetwork::failure(Index operation) const
+{
+  // Same chain of operations as reported by the Network
+  Result result(false);
+  for (Index cause = operation; cause != NONE; cause = mScheduledBy[cause])
+  {
+    result.push(mSources[cause]);
+  }
+  return result;
+}
+
+}}
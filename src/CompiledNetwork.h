@@ -0,0 +1,229 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "Result.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace common { namespace constraints {
+
+class IOperation;
+class IWire;
+class ThreadPool;
+
+/** A frozen copy of a Network, stored as flat arrays for cache-friendly
+    evaluation.
+
+    Wires are replaced by indices into a single array of values and operations
+    by entries in a tape of opcodes and operand indices, sorted in topological
+    order. The wires consuming each value are stored as a compressed sparse
+    row list. Setting a value evaluates the affected part of the tape without
+    virtual calls or pointer chasing, and gives the same results as setting
+    the corresponding Wire in the Network it was compiled from.
+
+    The compiled network does not share state with its Network; values set on
+    one are not visible in the other.
+
+    \see \ref Network::compile
+ */
+class CompiledNetwork
+{
+public:
+  typedef std::uint32_t Index;
+
+  /** Index used for a missing wire or operation, e.g., the output of a
+      relation.
+   */
+  static const Index NONE;
+
+  enum Opcode : std::uint8_t
+  {
+    ADD,
+    MULTIPLY,
+    LESS_OR_EQUAL,
+    /** A weighted sum of any number of wires plus a constant. */
+    LINEAR,
+    /** Holds if the first operand is within the limits. */
+    BOUNDS,
+    /** Holds if the second operand minus the first is within the limits. */
+    EQUAL,
+    MIN,
+    MAX,
+    /** Unary; both operands refer to the input. */
+    ABS,
+    /** Unary; limits the input to the lower and upper limits. */
+    CLAMP
+  };
+
+  /** Outcome of evaluating a batch of scenarios. */
+  struct BatchResult
+  {
+    /** Checks if all relations hold in a scenario. */
+    bool hasPassed(std::size_t scenario) const;
+
+    /** One bit per scenario, set if all relations hold. */
+    std::vector<std::uint64_t> passed;
+    /** Per scenario, the tape index of the first relation that does not hold,
+        or NONE.
+     */
+    std::vector<Index> firstFailure;
+  };
+
+  CompiledNetwork(CompiledNetwork&& other) = default;
+  CompiledNetwork& operator=(CompiledNetwork&& other) = default;
+
+  /** Gets the index of a wire from the network this was compiled from. */
+  Index indexOf(const IWire& wire) const;
+
+  std::size_t getWireCount() const;
+  std::size_t getOperationCount() const;
+
+  double get(Index wire) const;
+  /** Assigns a value to a wire and evaluates the operations downstream of it.
+      \return a result object to know if the value was allowed
+   */
+  Result set(Index wire, double value);
+  /** Assigns a value to a wire and evaluates the operations downstream of it
+      level by level, spreading each level over the threads of a pool. The
+      result is the same as the one reported by sequential evaluation.
+
+      This pays off for wide networks, where a change affects thousands of
+      independent operations at each level; small levels are evaluated on the
+      calling thread.
+   */
+  Result set(Index wire, double value, ThreadPool& pool);
+  /** Re-evaluates every operation in the tape and verifies all relations.
+      \return a result object to know if all the relations hold
+   */
+  Result verify();
+
+  /** Evaluates the whole tape for many scenarios at once, without modifying
+      the values of the compiled network. Each scenario assigns one value to
+      each of the input wires, taken from the corresponding column, and uses
+      the current values for all other undriven wires. The scenarios are
+      evaluated in lockstep using SIMD instructions where available.
+
+      \param inputs the wires that vary between scenarios
+      \param columns one array of scenarioCount values per input wire
+      \param scenarioCount the number of scenarios
+   */
+  BatchResult evaluateBatch(const std::vector<Index>& inputs,
+                            const std::vector<const double*>& columns,
+                            std::size_t scenarioCount) const;
+
+  /** Gets the name of an operation in the tape, e.g., a failing relation. */
+  std::string getOperationName(Index operation) const;
+
+private:
+  CompiledNetwork(const CompiledNetwork&) = delete;
+  void operator=(const CompiledNetwork&) = delete;
+  CompiledNetwork() = default;
+
+  /** Adds a wire with its current value, in the order wires are compiled. */
+  void addWire(const IWire& wire);
+  /** Appends an operation to the tape. Operations must be appended in
+      topological order.
+   */
+  void addOperation(const IOperation& source,
+                    unsigned int rank,
+                    Opcode opcode,
+                    const IWire& operandA,
+                    const IWire& operandB,
+                    const IWire* output);
+  /** Appends a weighted sum of distinct wires to the tape. */
+  void addLinearOperation(
+    const IOperation& source,
+    unsigned int rank,
+    const std::vector<std::pair<const IWire*, double>>& terms,
+    double constant,
+    const IWire& output);
+  /** Appends an operation with literal limits to the tape. */
+  void addBoundedOperation(const IOperation& source,
+                           unsigned int rank,
+                           Opcode opcode,
+                           const IWire& operandA,
+                           const IWire& operandB,
+                           const IWire* output,
+                           double lower,
+                           double upper);
+  /** Builds the consumer lists once all operations have been added. */
+  void finish();
+
+  /** Evaluates one operation of the tape.
+      \return false if the operation is a relation that does not hold
+   */
+  bool evaluate(Index operation);
+  void scheduleConsumers(Index wire, Index scheduledBy);
+  Result failure(Index operation) const;
+  /** Evaluates the operations in [begin, end) of one level whose operands
+      changed in the current parallel propagation, stopping at the first
+      failing relation.
+      \return the failing relation, or NONE
+   */
+  Index evaluateChanged(Index begin, Index end);
+
+private:
+  std::unordered_map<const IWire*, Index> mIndices;
+
+  // Per wire
+  std::vector<double> mValues;
+  /** The operation driving each wire, or NONE. */
+  std::vector<Index> mDrivers;
+  /** Offsets into mConsumers, one more than the number of wires. */
+  std::vector<Index> mConsumerOffsets;
+  std::vector<Index> mConsumers;
+
+  // Per operation, in topological order
+  std::vector<Opcode> mOpcodes;
+  std::vector<Index> mOperandsA;
+  std::vector<Index> mOperandsB;
+  std::vector<Index> mOutputs;
+  /** Offsets into the terms of linear operations, one more than the number
+      of operations. Other operations have no terms and use the operands.
+   */
+  std::vector<Index> mTermOffsets = std::vector<Index>(1, 0);
+  std::vector<Index> mTermWires;
+  std::vector<double> mTermCoefficients;
+  /** Constant of each linear operation, zero for others. */
+  std::vector<double> mConstants;
+  /** Limits of each window, equality and clamp operation, zero for others.
+   */
+  std::vector<double> mLowerLimits;
+  std::vector<double> mUpperLimits;
+  /** Start of each topological level in the tape, plus the end of the tape.
+   */
+  std::vector<Index> mLevelOffsets;
+  unsigned int mLastRank = 0;
+  /** Original operations, only used for error messages. */
+  std::vector<const IOperation*> mSources;
+
+  // Scheduling state, kept between calls to avoid reallocation
+  /** One bit per operation that is scheduled for evaluation. Since the tape
+      is in topological order, scanning the bits from low to high evaluates
+      every operation after its inputs.
+   */
+  std::vector<std::uint64_t> mScheduled;
+  std::vector<Index> mScheduledBy;
+  /** The parallel propagation in which each wire was last changed. */
+  std::vector<std::uint32_t> mChangedEpochs;
+  std::uint32_t mEpoch = 0;
+  /** The wire assigned by the current parallel propagation. */
+  Index mAssigned = NONE;
+  /** Output value of each operation before its last parallel evaluation,
+      used to undo the writes behind a failing relation.
+   */
+  std::vector<double> mPreviousOutputs;
+
+  // Allow network to compile itself
+  friend class Network;
+  // Allow operations to add themselves
+  friend class IOperation;
+  // Allow exporter to read the topology
+  friend class Exporter;
+};
+
+}}
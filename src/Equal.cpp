@@ -0,0 +1,115 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Equal.h"
+
+#include "Bounds.h"
+#include "IWire.h"
+#include "Network.h"
+
+#include <assert.h>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Equal::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  return s.str();
+}
+
+std::string Equal::getShortDescription() const
+{
+  std::ostringstream name;
+  name << mLeft.getShortDescription() << " == " << mRight.getShortDescription();
+  if (mTolerance != 0)
+  {
+    name << " within " << mTolerance;
+  }
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Equal::Equal(IWire& left, IWire& right, Value tolerance)
+  : mLeft(left)
+  , mRight(right)
+  , mTolerance(tolerance)
+{
+  assert(!(tolerance < 0));
+  connect(mLeft);
+  connect(mRight);
+  bool valid = propagateValue();
+  if (getNetwork(mLeft).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Equal::propagateValue()
+{
+  const Value difference = mRight.get() - mLeft.get();
+  Result r = Result(-mTolerance <= difference && difference <= mTolerance);
+  if (!r)
+  {
+    r.push(this);
+  }
+  return r;
+}
+
+Range Equal::range(const IWire& varyingWire) const
+{
+  // Solve -tolerance <= right - left <= tolerance for varyingWire
+  return Bounds::solve(mRight.expression(varyingWire)
+                         - mLeft.expression(varyingWire),
+                       -mTolerance,
+                       mTolerance);
+}
+
+std::string Equal::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail";
+  return s.str();
+}
+
+WireExpression Equal::expression(const IWire& varyingWire) const
+{
+  // Should never be called.
+  (void)varyingWire;
+  exit(1);
+}
+
+void Equal::compile(CompiledNetwork& compiled) const
+{
+  const double tolerance = static_cast<double>(mTolerance);
+  compileBoundedAs(compiled,
+                   CompiledNetwork::EQUAL,
+                   mLeft,
+                   mRight,
+                   nullptr,
+                   -tolerance,
+                   tolerance);
+}
+
+void Equal::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mLeft);
+  inputs.push_back(&mRight);
+}
+
+void Equal::writeName(NameWriter& name) const
+{
+  name.wire(mLeft);
+  name.text(" == ");
+  name.wire(mRight);
+  if (mTolerance != 0)
+  {
+    name.text(" within ");
+    name.value(mTolerance);
+  }
+}
+
+}}
@@ -0,0 +1,42 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "IOperation.h"
+#include "IWire.h"
+
+namespace common { namespace constraints {
+
+/** Models an equality relation between two wires, which holds when the
+    values differ by at most a tolerance.
+ */
+class Equal : public IOperation
+{
+public:
+  virtual ~Equal(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+private:
+  Equal(const Equal&) = delete;
+  void operator=(const Equal&) = delete;
+  Equal(IWire& left, IWire& right, Value tolerance);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& varyingWire) const override;
+  virtual WireExpression expression(const IWire& varyingWire) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
+private:
+  IWire& mLeft;
+  IWire& mRight;
+  Value mTolerance;
+
+  // Allow network factory functions to create equality objects
+  friend class Network;
+  friend class EqualTest;
+};
+}}
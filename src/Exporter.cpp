@@ -0,0 +1,494 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Exporter.h"
+
+#include "IOperation.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+namespace {
+
+using common::constraints::CompiledNetwork;
+
+const char* getSymbol(CompiledNetwork::Opcode opcode)
+{
+  switch (opcode)
+  {
+  case CompiledNetwork::ADD:
+    return "+";
+  case CompiledNetwork::MULTIPLY:
+    return "*";
+  case CompiledNetwork::LESS_OR_EQUAL:
+    return "<=";
+  case CompiledNetwork::LINEAR:
+    return "+";
+  case CompiledNetwork::BOUNDS:
+    return "in";
+  case CompiledNetwork::EQUAL:
+    return "==";
+  case CompiledNetwork::MIN:
+    return "min";
+  case CompiledNetwork::MAX:
+    return "max";
+  case CompiledNetwork::ABS:
+    return "abs";
+  case CompiledNetwork::CLAMP:
+    return "clamp";
+  }
+  return "";
+}
+
+const char* getKind(CompiledNetwork::Opcode opcode)
+{
+  switch (opcode)
+  {
+  case CompiledNetwork::ADD:
+    return "add";
+  case CompiledNetwork::MULTIPLY:
+    return "multiply";
+  case CompiledNetwork::LESS_OR_EQUAL:
+    return "lessOrEqual";
+  case CompiledNetwork::LINEAR:
+    return "linear";
+  case CompiledNetwork::BOUNDS:
+    return "bounds";
+  case CompiledNetwork::EQUAL:
+    return "equal";
+  case CompiledNetwork::MIN:
+    return "min";
+  case CompiledNetwork::MAX:
+    return "max";
+  case CompiledNetwork::ABS:
+    return "abs";
+  case CompiledNetwork::CLAMP:
+    return "clamp";
+  }
+  return "";
+}
+
+/** Writes text as the contents of a quoted DOT or JSON string. */
+void writeEscaped(std::ostream& s, const char* text)
+{
+  static const char HEX[] = "0123456789abcdef";
+  for (; *text != '\0'; ++text)
+  {
+    const unsigned char c = static_cast<unsigned char>(*text);
+    if (c == '"' || c == '\\')
+    {
+      s << '\\' << c;
+    }
+    else if (c == '\n')
+    {
+      s << "\\n";
+    }
+    else if (c < 0x20)
+    {
+      s << "\\u00" << HEX[c >> 4] << HEX[c & 0xf];
+    }
+    else
+    {
+      s << *text;
+    }
+  }
+}
+
+/** Writes a JSON number, or null if it is not finite. */
+void writeNumber(std::ostream& s, double value)
+{
+  if (std::isfinite(value))
+  {
+    s << value;
+  }
+  else
+  {
+    s << "null";
+  }
+}
+
+void indent(std::ostream& s, unsigned int indentationLevel)
+{
+  for (unsigned int i = 0; i < indentationLevel; ++i)
+  {
+    s << "  ";
+  }
+}
+
+}
+
+namespace common { namespace constraints {
+
+Exporter::Exporter(const Network& network)
+  : mCompiled(network.compile())
+{
+  index();
+  for (Index wire = 0; wire < mWires.size(); ++wire)
+  {
+    if (mCompiled.mDrivers[wire] == CompiledNetwork::NONE &&
+        !mWires[wire]->isConstant())
+    {
+      mRoots.push_back(wire);
+    }
+  }
+  for (Index operation = 0; operation < mCompiled.getOperationCount();
+       ++operation)
+  {
+    mOperations.push_back(operation);
+  }
+  mExported.assign(mWires.size(), true);
+  computeRanges(network, mExported);
+}
+
+Exporter::Exporter(const Wire& root)
+  : Exporter(root, true)
+{
+}
+
+void Exporter::write(std::ostream& s, Format format) const
+{
+  switch (format)
+  {
+  case TEXT:
+    writeText(s);
+    break;
+  case DOT:
+    writeDot(s);
+    break;
+  case JSON:
+    writeJson(s);
+    break;
+  }
+}
+
+void Exporter::writeText(std::ostream& s, unsigned int indentationLevel) const
+{
+  for (auto root : mRoots)
+  {
+    writeText(s, root, indentationLevel);
+  }
+}
+
+void Exporter::writeDot(std::ostream& s) const
+{
+  s << "digraph Network {\n";
+  for (Index wire = 0; wire < mWires.size(); ++wire)
+  {
+    if (!mExported[wire])
+    {
+      continue;
+    }
+    const char* name = mWires[wire]->mName;
+    s << "  w" << wire << " [shape=box, label=\"";
+    writeEscaped(s, name != nullptr ? name : "");
+    s << "\\n" << mWires[wire]->get() << "\\n";
+    writeRange(s, wire);
+    s << "\"];\n";
+  }
+  for (auto operation : mOperations)
+  {
+    s << "  o" << operation << " [shape=circle, label=\""
+      << getSymbol(mCompiled.mOpcodes[operation]) << "\"];\n";
+    for (auto input : getInputs(operation))
+    {
+      s << "  w" << input << " -> o" << operation << ";\n";
+    }
+    if (mCompiled.mOutputs[operation] != CompiledNetwork::NONE)
+    {
+      s << "  o" << operation << " -> w" << mCompiled.mOutputs[operation]
+        << ";\n";
+    }
+  }
+  s << "}\n";
+}
+
+void Exporter::writeJson(std::ostream& s) const
+{
+  const std::streamsize precision =
+    s.precision(std::numeric_limits<double>::max_digits10);
+
+  s << "{\"wires\":[";
+  bool first = true;
+  for (Index wire = 0; wire < mWires.size(); ++wire)
+  {
+    if (!mExported[wire])
+    {
+      continue;
+    }
+    s << (first ? "" : ",") << "{\"id\":" << wire << ",\"name\":";
+    first = false;
+    if (mWires[wire]->mName != nullptr)
+    {
+      s << "\"";
+      writeEscaped(s, mWires[wire]->mName);
+      s << "\"";
+    }
+    else
+    {
+      s << "null";
+    }
+    s << ",\"value\":";
+    writeNumber(s, static_cast<double>(mWires[wire]->get()));
+    s << ",\"range\":";
+    const Range& range = mRanges[wire];
+    if (!mSolved[wire])
+    {
+      s << "null,\"nonlinear\":true";
+    }
+    else if (range.isEmpty())
+    {
+      s << "null";
+    }
+    else
+    {
+      s << "[";
+      writeNumber(s, static_cast<double>(range.lower));
+      s << ",";
+      writeNumber(s, static_cast<double>(range.upper));
+      s << "]";
+    }
+    s << ",\"constant\":" << (mWires[wire]->isConstant() ? "true" : "false")
+      << "}";
+  }
+
+  s << "],\"operations\":[";
+  first = true;
+  for (auto operation : mOperations)
+  {
+    s << (first ? "" : ",") << "{\"id\":" << operation << ",\"kind\":\""
+      << getKind(mCompiled.mOpcodes[operation]) << "\",\"inputs\":[";
+    first = false;
+    const char* separator = "";
+    for (auto input : getInputs(operation))
+    {
+      s << separator << input;
+      separator = ",";
+    }
+    s << "],";
+    if (mCompiled.mOpcodes[operation] == CompiledNetwork::LINEAR)
+    {
+      s << "\"coefficients\":[";
+      separator = "";
+      for (Index term = mCompiled.mTermOffsets[operation];
+           term < mCompiled.mTermOffsets[operation + 1];
+           ++term)
+      {
+        s << separator;
+        writeNumber(s, mCompiled.mTermCoefficients[term]);
+        separator = ",";
+      }
+      s << "],\"constant\":";
+      writeNumber(s, mCompiled.mConstants[operation]);
+      s << ",";
+    }
+    else if (mCompiled.mOpcodes[operation] == CompiledNetwork::BOUNDS
+             || mCompiled.mOpcodes[operation] == CompiledNetwork::EQUAL
+             || mCompiled.mOpcodes[operation] == CompiledNetwork::CLAMP)
+    {
+      s << "\"limits\":[";
+      writeNumber(s, mCompiled.mLowerLimits[operation]);
+      s << ",";
+      writeNumber(s, mCompiled.mUpperLimits[operation]);
+      s << "],";
+    }
+    s << "\"output\":";
+    if (mCompiled.mOutputs[operation] != CompiledNetwork::NONE)
+    {
+      s << mCompiled.mOutputs[operation];
+    }
+    else
+    {
+      s << "null";
+    }
+    s << "}";
+  }
+  s << "]}\n";
+
+  s.precision(precision);
+}
+
+const Range& Exporter::getRange(const Wire& wire) const
+{
+  const Index index = mCompiled.indexOf(wire);
+  assert(mExported[index]);
+  return mRanges[index];
+}
+
+bool Exporter::isSolved(const Wire& wire) const
+{
+  const Index index = mCompiled.indexOf(wire);
+  assert(mExported[index]);
+  return mSolved[index];
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Exporter::Exporter(const Wire& root, bool inputRanges)
+  : mCompiled(root.mNetwork.compileDownstream(root))
+{
+  index();
+  mExported.assign(mWires.size(), false);
+  // Placeholders of an exhausted network are not part of the snapshot
+  auto found = mCompiled.mIndices.find(&root);
+  if (found != mCompiled.mIndices.end())
+  {
+    mRoots.push_back(found->second);
+    mExported[found->second] = true;
+  }
+
+  // The text format only shows the root and the outputs downstream of it
+  std::vector<bool> printed(mExported);
+  std::vector<bool> visited(mCompiled.getOperationCount(), false);
+  std::vector<Index> pending(mRoots);
+  while (!pending.empty())
+  {
+    const Index wire = pending.back();
+    pending.pop_back();
+    for (Index consumer = mCompiled.mConsumerOffsets[wire];
+         consumer < mCompiled.mConsumerOffsets[wire + 1];
+         ++consumer)
+    {
+      const Index operation = mCompiled.mConsumers[consumer];
+      if (visited[operation])
+      {
+        continue;
+      }
+      visited[operation] = true;
+      mOperations.push_back(operation);
+      for (auto input : getInputs(operation))
+      {
+        mExported[input] = true;
+      }
+      const Index output = mCompiled.mOutputs[operation];
+      if (output != CompiledNetwork::NONE)
+      {
+        mExported[output] = true;
+        printed[output] = true;
+        pending.push_back(output);
+      }
+    }
+  }
+  std::sort(mOperations.begin(), mOperations.end());
+  computeRanges(root.mNetwork, inputRanges ? mExported : printed);
+  if (inputRanges)
+  {
+    // Wires not downstream of the root also have relations elsewhere
+    const Network& network = root.mNetwork;
+    for (Index wire = 0; wire < mWires.size(); ++wire)
+    {
+      if (mExported[wire] && mWires[wire] != &root
+          && mCompiled.mDrivers[wire] == CompiledNetwork::NONE)
+      {
+        bool solved = true;
+        network.beginQuery();
+        mRanges[wire] =
+          network.rangeDownstream(*mWires[wire], *mWires[wire], &solved);
+        mSolved[wire] = solved;
+        if (!solved)
+        {
+          mRanges[wire] = Range::FULL;
+        }
+      }
+    }
+  }
+}
+
+void Exporter::index()
+{
+  mWires.resize(mCompiled.getWireCount());
+  for (auto& entry : mCompiled.mIndices)
+  {
+    mWires[entry.second] = static_cast<const Wire*>(entry.first);
+  }
+  for (Index operation = 0; operation < mCompiled.getOperationCount();
+       ++operation)
+  {
+    mOperationIndices.emplace(mCompiled.mSources[operation], operation);
+  }
+}
+
+void Exporter::computeRanges(const Network& network,
+                             const std::vector<bool>& wanted)
+{
+  mRanges = network.computeRanges(mCompiled, wanted, mSolved);
+}
+
+void Exporter::writeRange(std::ostream& s, Index wire) const
+{
+  if (mSolved[wire])
+  {
+    s << mRanges[wire];
+  }
+  else
+  {
+    s << "nonlinear";
+  }
+}
+
+std::vector<Exporter::Index> Exporter::getInputs(Index operation) const
+{
+  if (mCompiled.mOpcodes[operation] == CompiledNetwork::LINEAR)
+  {
+    return std::vector<Index>(
+      mCompiled.mTermWires.begin() + mCompiled.mTermOffsets[operation],
+      mCompiled.mTermWires.begin() + mCompiled.mTermOffsets[operation + 1]);
+  }
+  if (mCompiled.mOpcodes[operation] == CompiledNetwork::BOUNDS
+      || mCompiled.mOpcodes[operation] == CompiledNetwork::ABS
+      || mCompiled.mOpcodes[operation] == CompiledNetwork::CLAMP)
+  {
+    return {mCompiled.mOperandsA[operation]};
+  }
+  return {mCompiled.mOperandsA[operation], mCompiled.mOperandsB[operation]};
+}
+
+void Exporter::writeText(std::ostream& s,
+                         Index wire,
+                         unsigned int indentationLevel) const
+{
+  // A wire whose line has been written, and the next of its operations
+  struct Level
+  {
+    const Wire* node;
+    unsigned int indentationLevel;
+    std::size_t next;
+  };
+
+  std::vector<Level> stack;
+  auto enter = [&](Index index, unsigned int level) {
+    const Wire& node = *mWires[index];
+    indent(s, level);
+    s << node.getName() << " with value " << node.get() << " and range ";
+    writeRange(s, index);
+    s << "\n";
+    stack.push_back(Level{&node, level, 0});
+  };
+
+  enter(wire, indentationLevel);
+  while (!stack.empty())
+  {
+    Level& top = stack.back();
+    if (top.next == top.node->mOperations.size())
+    {
+      stack.pop_back();
+      continue;
+    }
+    const IOperation* operation = top.node->mOperations[top.next++];
+    const unsigned int level = top.indentationLevel + 1;
+    indent(s, level);
+    s << operation->getShortDescription() << "\n";
+    auto found = mOperationIndices.find(operation);
+    if (found != mOperationIndices.end() &&
+        mCompiled.mOutputs[found->second] != CompiledNetwork::NONE)
+    {
+      enter(mCompiled.mOutputs[found->second], level + 1);
+    }
+  }
+}
+
+}}
@@ -0,0 +1,120 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "CompiledNetwork.h"
+#include "Range.h"
+
+#include <unordered_map>
+#include <vector>
+
+// Forward-declares std::ostream
+#include <iosfwd>
+
+namespace common { namespace constraints {
+
+class IOperation;
+class Network;
+class Wire;
+
+/** Writes a network, or the part of it downstream of a wire, to a stream.
+
+    The range of every exported wire is computed once when the exporter is
+    created, in one sweep over the snapshot instead of one query per wire,
+    and the output is written straight to the stream without building
+    intermediate strings. A wire that a relation depends on nonlinearly has
+    no range that can be solved, and is written as nonlinear instead. Besides the text format of \ref Wire::dump, the
+    network can be written as a Graphviz DOT graph or as JSON for tooling.
+
+    The exporter takes a snapshot of the network; wires and operations added
+    afterwards, or values set afterwards, are not part of the output.
+
+    Example code writing a network for Graphviz:
+    \code{.cpp}
+      std::ofstream file("network.dot");
+      Exporter(network).write(file, Exporter::DOT);
+    \endcode
+ */
+class Exporter
+{
+public:
+  enum Format
+  {
+    /** One indented tree per root wire, as written by Wire::dump. */
+    TEXT,
+    /** A Graphviz digraph with one node per wire and per operation. */
+    DOT,
+    /** An object holding an array of wires and an array of operations. */
+    JSON
+  };
+
+  /** Prepares to export a whole network. In the text format, every undriven
+      wire that is not a constant is the root of a tree.
+   */
+  explicit Exporter(const Network& network);
+  /** Prepares to export the operations downstream of a wire, together with
+      all the wires they connect to. Only that part of the network is
+      compiled. In the text format, the wire is the only root.
+   */
+  explicit Exporter(const Wire& root);
+
+  void write(std::ostream& s, Format format) const;
+  /** Writes the text format, indenting the roots by the given level. */
+  void writeText(std::ostream& s, unsigned int indentationLevel = 0) const;
+  void writeDot(std::ostream& s) const;
+  void writeJson(std::ostream& s) const;
+
+  /** Gets the range computed for an exported wire, or the full range if it
+      is not solved.
+   */
+  const Range& getRange(const Wire& wire) const;
+  /** Checks whether the range of an exported wire could be solved, i.e.,
+      whether no relation depends on it nonlinearly.
+   */
+  bool isSolved(const Wire& wire) const;
+
+private:
+  typedef CompiledNetwork::Index Index;
+
+  /** Prepares to export the operations downstream of a wire. The wires that
+      only feed those operations have relations elsewhere in the network, so
+      their ranges are queried one by one, unless left out because only the
+      text format is written, which does not show them.
+   */
+  Exporter(const Wire& root, bool inputRanges);
+
+  /** Indexes the wires and operations of the compiled snapshot. */
+  void index();
+  /** Computes the ranges of the wanted wires. */
+  void computeRanges(const Network& network, const std::vector<bool>& wanted);
+  /** Writes the range of a wire, or that it is not solved. */
+  void writeRange(std::ostream& s, Index wire) const;
+  /** Gets the input wires of an operation, in order. */
+  std::vector<Index> getInputs(Index operation) const;
+  /** Writes the tree of downstream wires and operations of a wire. The tree
+      is walked on a work stack, so deep networks need no native stack.
+   */
+  void writeText(std::ostream& s,
+                 Index wire,
+                 unsigned int indentationLevel) const;
+
+private:
+  CompiledNetwork mCompiled;
+  /** Wires by their index in the snapshot. */
+  std::vector<const Wire*> mWires;
+  std::unordered_map<const IOperation*, Index> mOperationIndices;
+  /** Wires written as the roots of the text format. */
+  std::vector<Index> mRoots;
+  /** Exported operations, in tape order. */
+  std::vector<Index> mOperations;
+  std::vector<bool> mExported;
+  /** Ranges by wire index, only computed for the wires written with their
+      range.
+   */
+  std::vector<Range> mRanges;
+  std::vector<bool> mSolved;
+
+  // Allow wires to dump themselves without querying the rest of the network
+  friend class Wire;
+};
+
+}}
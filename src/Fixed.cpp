@@ -0,0 +1,180 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Fixed.h"
+
+#include <ostream>
+
+namespace {
+
+using common::constraints::Fixed;
+
+const std::int64_t ONE = std::int64_t(1) << Fixed::FRACTIONAL_BITS;
+
+std::int32_t saturate(std::int64_t raw)
+{
+  if (raw > INT32_MAX)
+  {
+    return INT32_MAX;
+  }
+  if (raw < INT32_MIN)
+  {
+    return INT32_MIN;
+  }
+  return static_cast<std::int32_t>(raw);
+}
+
+/** Checks if a raw value is one of the two stand-ins for infinity. */
+bool isInfinite(std::int32_t raw)
+{
+  return raw == INT32_MAX || raw == INT32_MIN;
+}
+
+/** Returns the infinity with the given sign, or zero. */
+std::int32_t infinity(int sign)
+{
+  return sign > 0 ? INT32_MAX : sign < 0 ? INT32_MIN : 0;
+}
+
+int sign(std::int32_t raw)
+{
+  return (raw > 0) - (raw < 0);
+}
+
+}
+
+namespace common { namespace constraints {
+
+const int Fixed::FRACTIONAL_BITS;
+
+Fixed::Fixed()
+  : mRaw(0)
+{
+}
+
+Fixed::Fixed(double value)
+  : mRaw(0)
+{
+  const double scaled = value * ONE;
+  if (scaled >= INT32_MAX)
+  {
+    mRaw = INT32_MAX;
+  }
+  else if (scaled <= INT32_MIN)
+  {
+    mRaw = INT32_MIN;
+  }
+  else if (scaled == scaled)
+  {
+    mRaw = static_cast<std::int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+  }
+}
+
+Fixed Fixed::fromRaw(std::int32_t raw)
+{
+  Fixed value;
+  value.mRaw = raw;
+  return value;
+}
+
+std::int32_t Fixed::getRaw() const
+{
+  return mRaw;
+}
+
+Fixed::operator double() const
+{
+  if (isInfinite(mRaw))
+  {
+    return sign(mRaw) * std::numeric_limits<double>::infinity();
+  }
+  return static_cast<double>(mRaw) / ONE;
+}
+
+Fixed Fixed::operator-() const
+{
+  return fromRaw(isInfinite(mRaw) ? infinity(-sign(mRaw)) : -mRaw);
+}
+
+Fixed operator+(Fixed a, Fixed b)
+{
+  if (isInfinite(a.mRaw) || isInfinite(b.mRaw))
+  {
+    // Opposite infinities give NaN in floating point, which converts to zero
+    const int ia = isInfinite(a.mRaw) ? sign(a.mRaw) : 0;
+    const int ib = isInfinite(b.mRaw) ? sign(b.mRaw) : 0;
+    return Fixed::fromRaw(ia == -ib ? 0 : infinity(ia + ib));
+  }
+  return Fixed::fromRaw(saturate(std::int64_t(a.mRaw) + b.mRaw));
+}
+
+Fixed operator-(Fixed a, Fixed b)
+{
+  return a + -b;
+}
+
+Fixed operator*(Fixed a, Fixed b)
+{
+  if (isInfinite(a.mRaw) || isInfinite(b.mRaw))
+  {
+    return Fixed::fromRaw(infinity(sign(a.mRaw) * sign(b.mRaw)));
+  }
+  const std::int64_t product = std::int64_t(a.mRaw) * b.mRaw;
+  // Round half away from zero; division avoids shifting negative values
+  const std::int64_t half = ONE / 2;
+  return Fixed::fromRaw(
+    saturate((product < 0 ? product - half : product + half) / ONE));
+}
+
+Fixed operator/(Fixed a, Fixed b)
+{
+  if (isInfinite(b.mRaw))
+  {
+    return Fixed();
+  }
+  if (b.mRaw == 0)
+  {
+    return Fixed::fromRaw(infinity(sign(a.mRaw)));
+  }
+  if (isInfinite(a.mRaw))
+  {
+    return Fixed::fromRaw(infinity(sign(a.mRaw) * sign(b.mRaw)));
+  }
+  return Fixed::fromRaw(saturate(std::int64_t(a.mRaw) * ONE / b.mRaw));
+}
+
+bool operator==(Fixed a, Fixed b)
+{
+  return a.mRaw == b.mRaw;
+}
+
+bool operator!=(Fixed a, Fixed b)
+{
+  return a.mRaw != b.mRaw;
+}
+
+bool operator<(Fixed a, Fixed b)
+{
+  return a.mRaw < b.mRaw;
+}
+
+bool operator<=(Fixed a, Fixed b)
+{
+  return a.mRaw <= b.mRaw;
+}
+
+bool operator>(Fixed a, Fixed b)
+{
+  return a.mRaw > b.mRaw;
+}
+
+bool operator>=(Fixed a, Fixed b)
+{
+  return a.mRaw >= b.mRaw;
+}
+
+std::ostream& operator<<(std::ostream& s, Fixed value)
+{
+  return s << static_cast<double>(value);
+}
+
+}}
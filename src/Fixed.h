@@ -0,0 +1,94 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// Forward-declares std::ostream
+#include <iosfwd>
+
+namespace common { namespace constraints {
+
+/** A signed fixed-point number in Q16.16 format, for targets without a
+    floating-point unit.
+
+    The value is held as a 32-bit integer with 16 fractional bits, giving a
+    range of [-32768, 32768) in steps of 1/65536. Arithmetic saturates at the
+    ends of the range instead of overflowing, and the largest and lowest
+    values stand in for positive and negative infinity: they stay infinite
+    through arithmetic and convert to the infinities of double. Forms that
+    give NaN in floating point give zero instead. Products are rounded to the
+    nearest step and quotients towards zero. Division by zero saturates with
+    the sign of the dividend.
+
+    \see \ref Value
+ */
+class Fixed
+{
+public:
+  /** Number of fractional bits. */
+  static const int FRACTIONAL_BITS = 16;
+
+  /** Creates a zero value. */
+  Fixed();
+  /** Converts from a floating-point value, rounding to the nearest step and
+      saturating. NaN converts to zero.
+   */
+  Fixed(double value);
+
+  /** Creates a value from its raw Q16.16 representation. */
+  static Fixed fromRaw(std::int32_t raw);
+  /** Gets the raw Q16.16 representation. */
+  std::int32_t getRaw() const;
+
+  explicit operator double() const;
+
+  Fixed operator-() const;
+  friend Fixed operator+(Fixed a, Fixed b);
+  friend Fixed operator-(Fixed a, Fixed b);
+  friend Fixed operator*(Fixed a, Fixed b);
+  friend Fixed operator/(Fixed a, Fixed b);
+
+  friend bool operator==(Fixed a, Fixed b);
+  friend bool operator!=(Fixed a, Fixed b);
+  friend bool operator<(Fixed a, Fixed b);
+  friend bool operator<=(Fixed a, Fixed b);
+  friend bool operator>(Fixed a, Fixed b);
+  friend bool operator>=(Fixed a, Fixed b);
+
+private:
+  std::int32_t mRaw;
+};
+
+/** Helper function for stringifying a Fixed */
+std::ostream& operator<<(std::ostream& s, Fixed value);
+
+}}
+
+namespace std {
+
+/** Limits of Fixed, which has no infinity; its largest and lowest values are
+    used instead.
+ */
+template <>
+class numeric_limits<common::constraints::Fixed>
+{
+public:
+  typedef common::constraints::Fixed Fixed;
+
+  static const bool is_specialized = true;
+  static const bool is_signed = true;
+  static const bool is_integer = false;
+  static const bool is_exact = true;
+  static const bool has_infinity = false;
+  static const bool has_quiet_NaN = false;
+  static const int digits = 31;
+
+  static Fixed min() { return Fixed::fromRaw(1); }
+  static Fixed max() { return Fixed::fromRaw(INT32_MAX); }
+  static Fixed lowest() { return Fixed::fromRaw(INT32_MIN); }
+  static Fixed epsilon() { return Fixed::fromRaw(1); }
+  static Fixed infinity() { return max(); }
+};
+
+}
@@ -2,12 +2,17 @@
 
 #pragma once
 
+#include "Arena.h"
+#include "CompiledNetwork.h"
+#include "NameWriter.h"
 #include "Range.h"
 #include "Result.h"
 #include "Wire.h"
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace common { namespace constraints {
 
@@ -19,45 +24,163 @@ namespace common { namespace constraints {
 
     \see \ref Addition
     \see \ref LessOrEqual
+    \see \ref Bounds
  */
 class IOperation
 {
 public:
+  /** List of input wires, allocated like the other containers of a
+      network.
+   */
+  typedef std::vector<IWire*, ArenaAllocator<IWire*>> Inputs;
+  /** List of relations, allocated like the other containers of a
+      network.
+   */
+  typedef std::vector<const IOperation*, ArenaAllocator<const IOperation*>>
+    Relations;
+
   virtual ~IOperation() {}
 
   virtual std::string dump(unsigned int indentationLevel) const = 0;
   virtual std::string getShortDescription() const = 0;
-  virtual std::string getName() const = 0;
+  /** Gets the name of the operation in terms of the names of its inputs.
+      \see \ref writeName
+   */
+  std::string getName() const { return NameWriter::getName(*this); }
 
 protected:
   virtual Result propagateValue() = 0;
   /** Given the network downstream of this operation, computes the range of
-      varyingWire.
+      varyingWire. Range queries only call this for relations; for
+      operations with an output, the network continues at the output.
    */
   virtual Range range(const IWire& varyingWire) const = 0;
   /** Computes an expression for the value of this operation as a
-      function of varyingWire.
+      function of varyingWire. The network computes the expressions of the
+      inputs first, so they are memoized when this is called.
    */
   virtual WireExpression expression(const IWire& varyingWire) const = 0;
+  /** Appends every input wire that \ref expression may ask for an
+      expression.
+   */
+  virtual void appendInputs(Inputs& inputs) const = 0;
+  /** Describes the name of the operation to the writer, referring to the
+      input wires instead of asking them for their names.
+   */
+  virtual void writeName(NameWriter& name) const = 0;
   virtual std::string getErrorMessage() const = 0;
+  /** Appends this operation to the tape of a compiled network. */
+  virtual void compile(CompiledNetwork& compiled) const = 0;
+  /** Gets the level of the operation in a compiled network, which only
+      depends on operations of lower levels.
+   */
+  virtual unsigned int getLevel() const { return mRank; }
 
   /** Helper function to connect to a wire without having each subclass as a
       friend of IWire.
    */
   void connect(IWire& wire) { wire.connect(this); }
+  /** Helper function to disconnect from a wire without having each subclass
+      as a friend of IWire.
+   */
+  void disconnect(IWire& wire) { wire.disconnect(this); }
   /** Helper function to become the driver of a wire without having each
-      subclass as a friend of IWire.
+      subclass as a friend of IWire. Must be called after all inputs have been
+      connected, since the rank of the driven wire is derived from them.
    */
-  void drive(IWire& wire) { wire.setDriver(this); }
+  void drive(IWire& wire)
+  {
+    wire.setDriver(this);
+    mOutput = &wire;
+  }
   /** Helper function to access the network that a wire belongs to without
       having each subclass as a friend of IWire.
    */
   Network& getNetwork(IWire& wire) { return wire.getNetwork(); }
+  /** Helper function to add this operation to a compiled network without
+      having each subclass as a friend of CompiledNetwork.
+   */
+  void compileAs(CompiledNetwork& compiled,
+                 CompiledNetwork::Opcode opcode,
+                 const IWire& operandA,
+                 const IWire& operandB,
+                 const IWire* output) const
+  {
+    compiled.addOperation(
+      *this, getLevel(), opcode, operandA, operandB, output);
+  }
+  /** Helper function to add a weighted sum to a compiled network without
+      having each subclass as a friend of CompiledNetwork.
+   */
+  void compileLinearAs(
+    CompiledNetwork& compiled,
+    const std::vector<std::pair<const IWire*, double>>& terms,
+    double constant,
+    const IWire& output) const
+  {
+    compiled.addLinearOperation(*this, getLevel(), terms, constant, output);
+  }
+  /** Helper function to add an operation with literal limits to a compiled
+      network without having each subclass as a friend of CompiledNetwork.
+   */
+  void compileBoundedAs(CompiledNetwork& compiled,
+                        CompiledNetwork::Opcode opcode,
+                        const IWire& operandA,
+                        const IWire& operandB,
+                        const IWire* output,
+                        double lower,
+                        double upper) const
+  {
+    compiled.addBoundedOperation(
+      *this, getLevel(), opcode, operandA, operandB, output, lower, upper);
+  }
+  /** Gets the input whose change caused this operation to be evaluated, so
+      that the output can be updated incrementally.
+      \return the input, or null if several inputs changed or an earlier
+               change was not propagated to this operation
+   */
+  const IWire* getChangedInput() const
+  {
+    return mMissedUpdate ? nullptr : mChangedInput;
+  }
+
+private:
+  /** Topological rank, i.e., the highest rank among the input wires. An
+      operation is always evaluated after all operations of lower rank.
+   */
+  unsigned int mRank = 0;
+  /** The propagation in which this operation was last scheduled. */
+  unsigned long long mScheduledEpoch = 0;
+  /** The operation whose output caused this one to be scheduled, used to
+      reconstruct the chain of operations when a propagation fails.
+   */
+  const IOperation* mScheduledBy = nullptr;
+  /** The next operation scheduled with the same rank. */
+  IOperation* mNextScheduled = nullptr;
+  /** The wire driven by the operation, or null for relations. */
+  const IWire* mOutput = nullptr;
+  /** The input that caused this operation to be scheduled in the current
+      propagation, or null if there were several.
+   */
+  const IWire* mChangedInput = nullptr;
+  /** Whether an input may have changed without this operation being
+      evaluated, e.g., because a propagation failed before reaching it.
+   */
+  bool mMissedUpdate = false;
+  /** Whether a relation depends on the output, so that lazy evaluation
+      still evaluates the operation during propagation. Relations are
+      observed themselves.
+   */
+  bool mObserved = false;
 
   // Allow wire to propagate
   friend class Wire;
+  // Allow network to schedule propagation
+  friend class Network;
   // Allow result to read error message
   friend class Result;
+  // Allow name writer to expand nested names
+  friend class NameWriter;
 };
 
 }}
@@ -3,6 +3,7 @@
 
 #include "Range.h"
 #include "Result.h"
+#include "Value.h"
 #include "WireExpression.h"
 
 #include <memory>
@@ -12,6 +13,7 @@ namespace common { namespace constraints {
 
 class IOperation;
 class Network;
+class Wire;
 
 /** A wire models a value of a connection in a constraint network. It could
     either be a externally driven variable or the output of an operation in the
@@ -22,8 +24,8 @@ class IWire
 public:
   virtual ~IWire(){};
 
-  virtual double get() const = 0;
-  virtual Result set(double value) = 0;
+  virtual Value get() const = 0;
+  virtual Result set(Value value) = 0;
   /** Computes the allowed range of values for this wire */
   virtual Range range() const = 0;
   /** Given the network downstream of this wire, computes the range of
@@ -50,6 +52,10 @@ protected:
       the operation is made aware of the new value of this wire.
    */
   virtual void connect(IOperation* operation) = 0;
+  /** Removes an operation from the input side of this wire, undoing
+      \ref connect.
+   */
+  virtual void disconnect(IOperation* operation) = 0;
   /** Connects this wire to the output side of an operation. The given operation
       becomes the driver of the wire, i.e. sets its value during
       propagation.
@@ -59,8 +65,17 @@ protected:
   /** Gets the network that this wire belongs to. */
   virtual Network& getNetwork() const = 0;
 
+  /** Gets this wire as a wire of a network, which the network may walk
+      past without calling it through this interface. Other implementations
+      return null and are only called through this interface.
+   */
+  virtual const Wire* asWire() const { return nullptr; }
+
   // Allow operations to connect
   friend class IOperation;
+  // Allow network traversals to walk past wires
+  friend class Network;
+  friend class NameWriter;
 };
 
 }}
@@ -9,14 +9,27 @@
 #include <iostream>
 #include <sstream>
 
-namespace {
+namespace common { namespace constraints {
+
+std::string LessOrEqual::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  return s.str();
+}
+
+std::string LessOrEqual::getShortDescription() const
+{
+  std::ostringstream name;
+  name << mLeft.getShortDescription() << " <= " << mRight.getShortDescription();
+  return name.str();
+}
 
-using namespace common::constraints;
+// ----------------------------------------------------------------------------
+// Private functions
 
-/** Solve for x in the inequality a*x + b <= c*x + d
-    \return the range of values of x that satisfy the inequality
- */
-Range solveInequality(WireExpression left, WireExpression right)
+Range LessOrEqual::solveInequality(WireExpression left, WireExpression right)
 {
   // Change "left <= right" to general form:
   // 0 <= difference = right - left
@@ -31,67 +44,33 @@ Range solveInequality(WireExpression left, WireExpression right)
     assert(false);
   }
   // The difference is an expression of form k*x + m
-  const double k = difference.firstDegree;
-  const double m = difference.constant;
+  const Value k = difference.firstDegree;
+  const Value m = difference.constant;
 
   // When solving 0 <= k*x + m there are three cases:
+  Range solution;
 
   // Case I: k < 0: x <= -m/k
   if (k < 0)
   {
-    return Range(Range::NEGATIVE_INFINITY, -m / k);
+    solution = Range(Range::NEGATIVE_INFINITY, -m / k);
   }
   // Case II: k > 0: x >= -m/k
   else if (k > 0)
   {
-    return Range(-m / k, Range::POSITIVE_INFINITY);
+    solution = Range(-m / k, Range::POSITIVE_INFINITY);
   }
   // Case III: k == 0: 0 >= -m
-  else
+  // x can be any real number if m >= 0, otherwise there are no solutions
+  else if (m < 0)
   {
-    // x can be any real number if m >= 0
-    if (m >= 0)
-    {
-      return Range::FULL;
-    }
-    // otherwise no solutions for x
-    else
-    {
-      return Range::EMPTY;
-    }
+    solution = Range::EMPTY;
   }
-}
-
-}
-
-
-namespace common { namespace constraints {
-
-std::string LessOrEqual::dump(unsigned int indentationLevel) const
-{
-  std::ostringstream s;
-  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
-    << std::endl;
-  return s.str();
-}
-
-std::string LessOrEqual::getShortDescription() const
-{
-  std::ostringstream name;
-  name << mLeft.getShortDescription() << " <= " << mRight.getShortDescription();
-  return name.str();
-}
 
-std::string LessOrEqual::getName() const
-{
-  std::ostringstream name;
-  name << mLeft.getName() << " <= " << mRight.getName();
-  return name.str();
+  // The solution only holds where the expressions themselves hold
+  return Range::intersect(solution, difference.domain);
 }
 
-// ----------------------------------------------------------------------------
-// Private functions
-
 LessOrEqual::LessOrEqual(IWire& left, IWire& right)
   : mLeft(left)
   , mRight(right)
@@ -108,7 +87,10 @@ LessOrEqual::LessOrEqual(IWire& left, IWire& right)
 Result LessOrEqual::propagateValue()
 {
   Result r = Result(mLeft.get() <= mRight.get());
-  r.push(this);
+  if (!r)
+  {
+    r.push(this);
+  }
   return r;
 }
 
@@ -134,4 +116,22 @@ WireExpression LessOrEqual::expression(const IWire& varyingWire) const
   exit(1);
 }
 
+void LessOrEqual::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::LESS_OR_EQUAL, mLeft, mRight, nullptr);
+}
+
+void LessOrEqual::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mLeft);
+  inputs.push_back(&mRight);
+}
+
+void LessOrEqual::writeName(NameWriter& name) const
+{
+  name.wire(mLeft);
+  name.text(" <= ");
+  name.wire(mRight);
+}
+
 }}
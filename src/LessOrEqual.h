@@ -14,7 +14,6 @@ public:
 
   virtual std::string dump(unsigned int indentationLevel) const override;
   virtual std::string getShortDescription() const override;
-  virtual std::string getName() const override;
 
 private:
   LessOrEqual(const LessOrEqual&) = delete;
@@ -26,12 +25,26 @@ private:
   virtual WireExpression expression(const IWire& varyingWire) const override;
   virtual std::string getErrorMessage() const override;
 
+  /** Solve for x in the inequality a*x + b <= c*x + d
+      \return the range of values of x that satisfy the inequality and for
+      which both expressions hold
+   */
+  static Range solveInequality(WireExpression left, WireExpression right);
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
 private:
   IWire& mLeft;
   IWire& mRight;
 
   // Allow network factory functions to create comparison objects
   friend class Network;
+  // Allow piecewise operations to solve where their active piece holds
+  friend class Abs;
+  friend class Clamp;
+  friend class Max;
+  friend class Min;
   friend class LessOrEqualTest;
 };
 }}
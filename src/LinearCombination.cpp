@@ -0,0 +1,439 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "LinearCombination.h"
+
+#include "Network.h"
+#include "Wire.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+using common::constraints::IWire;
+using common::constraints::Value;
+
+std::size_t hash(const IWire& wire)
+{
+  std::size_t h = reinterpret_cast<std::uintptr_t>(&wire) >> 4;
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return h;
+}
+
+/** Checks that a value is neither infinite nor NaN, for any value type. */
+bool isFinite(Value value)
+{
+  return value - value == Value(0);
+}
+
+Value magnitude(Value value)
+{
+  return value < Value(0) ? Value(0) - value : value;
+}
+
+/** Adds a term to a sum with Neumaier's compensated summation, collecting
+    the low-order digits that the rounded sum loses in the compensation.
+ */
+void addCompensated(Value& sum, Value& compensation, Value term)
+{
+  const Value total = sum + term;
+  if (!isFinite(total))
+  {
+    // Nothing can be recovered from an infinite sum
+    sum = total;
+    return;
+  }
+  if (magnitude(sum) >= magnitude(term))
+  {
+    compensation = compensation + ((sum - total) + term);
+  }
+  else
+  {
+    compensation = compensation + ((term - total) + sum);
+  }
+  sum = total;
+}
+
+}
+
+namespace common { namespace constraints {
+
+const std::uint32_t LinearCombination::NONE =
+  std::numeric_limits<std::uint32_t>::max();
+
+std::string LinearCombination::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  s << mOutput->dump(indentationLevel + 1);
+  return s.str();
+}
+
+std::string LinearCombination::getShortDescription() const
+{
+  // Literal values are described like the constant wires they replace
+  std::ostringstream name;
+  const char* separator = "";
+  for (auto& term : mTerms)
+  {
+    name << separator << term.wire->getShortDescription();
+    if (isScaled(term))
+    {
+      name << " * (" << term.coefficient << ")=" << term.coefficient;
+    }
+    separator = " + ";
+  }
+  if (mConstant != Value(0))
+  {
+    name << separator << "(" << mConstant << ")=" << mConstant;
+  }
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+LinearCombination::LinearCombination(Arena& arena,
+                                     const Term* terms,
+                                     std::size_t count,
+                                     Value constant,
+                                     IWire& output)
+  : mOutput(&output)
+  , mTerms(terms, terms + count, ArenaAllocator<Term>(arena))
+  , mConstant(constant)
+  , mConnected(true)
+  , mInputs(ArenaAllocator<Input>(arena))
+  , mSlots(ArenaAllocator<std::uint32_t>(arena))
+  , mOffset(constant)
+  , mSum(constant)
+  , mCompensation(0)
+{
+  for (auto& term : mTerms)
+  {
+    addInput(*term.wire, term.coefficient);
+  }
+  drive(output);
+  bool valid = mOutput->set(recompute());
+  if (getNetwork(output).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result LinearCombination::propagateValue()
+{
+  // The chain of operations is added by the network if propagation fails.
+  // A check must leave the sum as it is, so it is only updated otherwise.
+  const bool checking = getNetwork(*mOutput).mProbing;
+  const IWire* changed = getChangedInput();
+  const std::uint32_t index = changed != nullptr ? findInput(*changed) : NONE;
+  if (index == NONE)
+  {
+    return mOutput->set(checking ? evaluate() : recompute());
+  }
+
+  Input& input = mInputs[index];
+  const Value value = input.wire->get();
+  // Adding the new product and taking out the old one, instead of adding the
+  // product of the difference, keeps the sum of the same terms as recompute
+  Value sum = mSum;
+  Value compensation = mCompensation;
+  addCompensated(sum, compensation, input.coefficient * value);
+  addCompensated(
+    sum, compensation, Value(0) - input.coefficient * input.included);
+  if (!isFinite(sum))
+  {
+    // Infinite values cannot be taken out of the sum again
+    return mOutput->set(checking ? evaluate() : recompute());
+  }
+  if (!checking)
+  {
+    input.included = value;
+    mSum = sum;
+    mCompensation = compensation;
+  }
+  return mOutput->set(sum + compensation);
+}
+
+Range LinearCombination::range(const IWire& varyingWire) const
+{
+  return mOutput->range(varyingWire);
+}
+
+WireExpression LinearCombination::expression(const IWire& varyingWire) const
+{
+  WireExpression sum = WireExpression::createLinear(0, 0);
+  if (mConnected)
+  {
+    // The inputs hold the merged terms, without walking the definition
+    for (auto& input : mInputs)
+    {
+      sum = sum
+            + WireExpression::createLinear(0, input.coefficient)
+                * input.wire->expression(varyingWire);
+    }
+    return sum + WireExpression::createLinear(0, mOffset);
+  }
+  for (auto& term : mTerms)
+  {
+    sum = sum
+          + WireExpression::createLinear(0, term.coefficient)
+              * term.wire->expression(varyingWire);
+  }
+  return sum + WireExpression::createLinear(0, mConstant);
+}
+
+std::string LinearCombination::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail because ";
+  return s.str();
+}
+
+void LinearCombination::compile(CompiledNetwork& compiled) const
+{
+  std::vector<std::pair<const IWire*, double>> terms;
+  double constant = 0;
+  if (mConnected)
+  {
+    terms.reserve(mInputs.size());
+    for (auto& input : mInputs)
+    {
+      terms.emplace_back(input.wire, static_cast<double>(input.coefficient));
+    }
+    constant = static_cast<double>(mOffset);
+  }
+  else
+  {
+    // Merge repeated terms, like the inputs when connected
+    std::unordered_map<const IWire*, std::size_t> indices;
+    for (auto& term : mTerms)
+    {
+      auto inserted = indices.emplace(term.wire, terms.size());
+      if (inserted.second)
+      {
+        terms.emplace_back(term.wire, static_cast<double>(term.coefficient));
+      }
+      else
+      {
+        terms[inserted.first->second].second +=
+          static_cast<double>(term.coefficient);
+      }
+    }
+    constant = static_cast<double>(mConstant);
+  }
+  compileLinearAs(compiled, terms, constant, *mOutput);
+}
+
+void LinearCombination::appendInputs(Inputs& inputs) const
+{
+  if (mConnected)
+  {
+    for (auto& input : mInputs)
+    {
+      inputs.push_back(input.wire);
+    }
+    return;
+  }
+  for (auto& term : mTerms)
+  {
+    inputs.push_back(term.wire);
+  }
+}
+
+void LinearCombination::writeName(NameWriter& name) const
+{
+  const char* separator = "";
+  for (auto& term : mTerms)
+  {
+    name.text(separator);
+    if (isScaled(term))
+    {
+      name.text("(");
+      name.wire(*term.wire);
+      name.text(") * (");
+      name.value(term.coefficient);
+      name.text(")");
+    }
+    else
+    {
+      name.wire(*term.wire);
+    }
+    separator = " + ";
+  }
+  if (mConstant != Value(0))
+  {
+    name.text(separator);
+    name.value(mConstant);
+  }
+}
+
+void LinearCombination::reconnect()
+{
+  assert(!mConnected);
+  mConnected = true;
+  mOffset = mConstant;
+  for (auto& term : mTerms)
+  {
+    addInput(*term.wire, term.coefficient);
+  }
+  mOutput->set(recompute());
+}
+
+void LinearCombination::disconnectInputs()
+{
+  assert(mConnected);
+  for (auto& input : mInputs)
+  {
+    disconnect(*input.wire);
+  }
+  mInputs.clear();
+  mSlots.clear();
+  mConnected = false;
+}
+
+void LinearCombination::absorb(LinearCombination& source)
+{
+  assert(mConnected && source.mConnected);
+  const std::uint32_t index = findInput(*source.mOutput);
+  assert(index != NONE);
+  const Value scale = mInputs[index].coefficient;
+  disconnect(*mInputs[index].wire);
+  mInputs[index] = mInputs.back();
+  mInputs.pop_back();
+  rehash(mSlots.size());
+
+  for (auto& input : source.mInputs)
+  {
+    addInput(*input.wire, scale * input.coefficient);
+  }
+  mOffset = mOffset + scale * source.mOffset;
+  source.disconnectInputs();
+  recompute();
+}
+
+bool LinearCombination::isScaled(const Term& term) const
+{
+  // A lone term without its coefficient would read like the wire itself
+  return term.coefficient != Value(1)
+         || (mTerms.size() == 1 && mConstant == Value(0));
+}
+
+bool LinearCombination::isConnected() const
+{
+  return mConnected;
+}
+
+std::size_t LinearCombination::countTerms() const
+{
+  return mTerms.size();
+}
+
+Value LinearCombination::evaluate() const
+{
+  Value sum = 0;
+  if (mConnected)
+  {
+    for (auto& input : mInputs)
+    {
+      sum = sum + input.coefficient * input.wire->get();
+    }
+    return mOffset + sum;
+  }
+  for (auto& term : mTerms)
+  {
+    sum = sum + term.coefficient * term.wire->get();
+  }
+  return mConstant + sum;
+}
+
+Value LinearCombination::recompute()
+{
+  mSum = mOffset;
+  mCompensation = 0;
+  for (auto& input : mInputs)
+  {
+    input.included = input.wire->get();
+    addCompensated(mSum, mCompensation, input.coefficient * input.included);
+  }
+  return mSum + mCompensation;
+}
+
+void LinearCombination::addInput(IWire& wire, Value coefficient)
+{
+  const std::uint32_t index = findInput(wire);
+  if (index != NONE)
+  {
+    Input& input = mInputs[index];
+    input.coefficient = input.coefficient + coefficient;
+    addCompensated(mSum, mCompensation, coefficient * input.included);
+    return;
+  }
+
+  connect(wire);
+  // Grow explicitly, so the memory taken from the arena is bounded by the
+  // number of terms on any standard library
+  if (mInputs.size() == mInputs.capacity())
+  {
+    mInputs.reserve(std::max<std::size_t>(4, 2 * mInputs.capacity()));
+  }
+  const Value value = wire.get();
+  mInputs.push_back(Input{&wire, coefficient, value});
+  addCompensated(mSum, mCompensation, coefficient * value);
+
+  if (2 * mInputs.size() > mSlots.size())
+  {
+    rehash(std::max<std::size_t>(8, 2 * mSlots.size()));
+  }
+  else
+  {
+    const std::size_t mask = mSlots.size() - 1;
+    std::size_t slot = hash(wire) & mask;
+    while (mSlots[slot] != NONE)
+    {
+      slot = (slot + 1) & mask;
+    }
+    mSlots[slot] = static_cast<std::uint32_t>(mInputs.size() - 1);
+  }
+}
+
+std::uint32_t LinearCombination::findInput(const IWire& wire) const
+{
+  if (mSlots.empty())
+  {
+    return NONE;
+  }
+  const std::size_t mask = mSlots.size() - 1;
+  for (std::size_t slot = hash(wire) & mask;; slot = (slot + 1) & mask)
+  {
+    const std::uint32_t index = mSlots[slot];
+    if (index == NONE || mInputs[index].wire == &wire)
+    {
+      return index;
+    }
+  }
+}
+
+void LinearCombination::rehash(std::size_t slots)
+{
+  mSlots.assign(slots, NONE);
+  const std::size_t mask = slots - 1;
+  for (std::uint32_t index = 0; index < mInputs.size(); ++index)
+  {
+    std::size_t slot = hash(*mInputs[index].wire) & mask;
+    while (mSlots[slot] != NONE)
+    {
+      slot = (slot + 1) & mask;
+    }
+    mSlots[slot] = index;
+  }
+}
+
+}}
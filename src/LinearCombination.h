@@ -0,0 +1,155 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "Arena.h"
+#include "IOperation.h"
+#include "IWire.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace common { namespace constraints {
+
+/** Models a weighted sum k1 * x1 + ... + kn * xn + c of any number of wires.
+
+    When one input changes, the output is updated by the change of that input
+    times its coefficient, so propagation takes the same time regardless of
+    the number of inputs. The expression of the output is the weighted sum of
+    the expressions of the inputs, formed in a single step.
+
+    The wire operators create linear combinations for sums of wires and for
+    scaling and offsetting by literal values. Each operator reads the wires
+    it is given, so in <tt>a + b + c</tt> the intermediate sum stays part of
+    the network and can be set, queried and dumped like any other wire. A
+    long sum is a single operation when built with
+    \ref Network::linearCombination, or once \ref Network::optimize has
+    merged a chain of sums that the application does not read.
+
+    \see \ref Network::linearCombination
+ */
+class LinearCombination : public IOperation
+{
+public:
+  /** A wire and its coefficient in the sum. */
+  struct Term
+  {
+    IWire* wire;
+    Value coefficient;
+  };
+
+  virtual ~LinearCombination(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+  /** Bound on the memory taken from the arena by the given number of
+      combinations with the given total number of terms, including growth
+      from merging and reconnecting them.
+   */
+  static constexpr std::size_t getMaxBytes(std::size_t combinations,
+                                           std::size_t terms)
+  {
+    return combinations * (8 * sizeof(std::uint32_t) + 4 * sizeof(Input))
+           + terms * (2 * sizeof(Term) + 4 * sizeof(Input)
+                      + 16 * sizeof(std::uint32_t));
+  }
+
+private:
+  /** An input wire while connected, with its merged coefficient and the
+      value it contributes to the current sum.
+   */
+  struct Input
+  {
+    IWire* wire;
+    Value coefficient;
+    Value included;
+  };
+
+  LinearCombination(const LinearCombination&) = delete;
+  void operator=(const LinearCombination&) = delete;
+  /** Creates a combination connected to its inputs and driving output. */
+  LinearCombination(Arena& arena,
+                    const Term* terms,
+                    std::size_t count,
+                    Value constant,
+                    IWire& output);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& varyingWire) const override;
+  virtual WireExpression expression(const IWire& varyingWire) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+  /** Connects a disconnected combination to its inputs again. */
+  void reconnect();
+  /** Disconnects the combination from its inputs, keeping its definition
+      for evaluating the output on demand.
+   */
+  void disconnectInputs();
+  /** Replaces the input driven by another connected combination with the
+      inputs of that one, scaled by the coefficient of the replaced input.
+      The other combination is left disconnected.
+   */
+  void absorb(LinearCombination& source);
+  /** Checks whether a term of the definition is written with its
+      coefficient in names and descriptions.
+   */
+  bool isScaled(const Term& term) const;
+  /** Checks whether the combination is connected to its inputs. */
+  bool isConnected() const;
+  /** Number of terms in the definition, counting repeated wires. */
+  std::size_t countTerms() const;
+  /** Computes the value of the output from the current input values,
+      without changing the sum.
+   */
+  Value evaluate() const;
+  /** Computes the sum from the current values of all inputs.
+      \return the new sum
+   */
+  Value recompute();
+
+  /** Adds a term to the connected inputs, merging it with an existing input
+      of the same wire.
+   */
+  void addInput(IWire& wire, Value coefficient);
+  /** \return the index of the input of a wire, or NONE */
+  std::uint32_t findInput(const IWire& wire) const;
+  /** Rebuilds the lookup table of the inputs with the given number of
+      slots, a power of two.
+   */
+  void rehash(std::size_t slots);
+
+private:
+  static const std::uint32_t NONE;
+
+  IWire* mOutput;
+
+  // Definition
+  std::vector<Term, ArenaAllocator<Term>> mTerms;
+  Value mConstant;
+
+  // Propagation state, only used while connected
+  bool mConnected;
+  std::vector<Input, ArenaAllocator<Input>> mInputs;
+  /** Open-addressing table of indices into mInputs, keyed by wire. */
+  std::vector<std::uint32_t, ArenaAllocator<std::uint32_t>> mSlots;
+  /** Sum of the constants of the definition. */
+  Value mOffset;
+  /** The output value, i.e., mOffset plus the included input values times
+      their coefficients, is mSum plus mCompensation. Updating the sum one
+      input at a time would otherwise lose small terms next to large ones
+      for good, since they are not added again.
+   */
+  Value mSum;
+  Value mCompensation;
+
+  // Allow network factory functions to create and merge combinations
+  friend class Network;
+  // Allow disconnected wires to be evaluated on demand
+  friend class Wire;
+  friend class LinearCombinationTest;
+};
+
+}}
@@ -0,0 +1,106 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Max.h"
+
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <assert.h>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Max::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  s << mMaximum.dump(indentationLevel + 1);
+  return s.str();
+}
+
+std::string Max::getShortDescription() const
+{
+  std::ostringstream name;
+  name << "max(" << mInputA.getShortDescription() << ", "
+       << mInputB.getShortDescription() << ")";
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Max::Max(IWire& inputA, IWire& inputB, IWire& maximum)
+  : mInputA(inputA)
+  , mInputB(inputB)
+  , mMaximum(maximum)
+{
+  connect(mInputA);
+  connect(mInputB);
+  drive(mMaximum);
+  bool valid = propagateValue();
+  if (getNetwork(mInputA).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Max::propagateValue()
+{
+  // The chain of operations is added by the network if propagation fails
+  const Value a = mInputA.get();
+  const Value b = mInputB.get();
+  return mMaximum.set(a >= b ? a : b);
+}
+
+Range Max::range(const IWire& varyingWire) const
+{
+  // The relations downstream restrict the maximum. Its expression keeps the
+  // varying wire where the larger input stays the larger.
+  return mMaximum.range(varyingWire);
+}
+
+std::string Max::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail because ";
+  return s.str();
+}
+
+WireExpression Max::expression(const IWire& varyingWire) const
+{
+  // Linear in the input that is currently the larger, as long as it stays
+  // the larger. If that cannot be solved, only the current value is known.
+  const bool aIsLarger = mInputA.get() >= mInputB.get();
+  WireExpression larger =
+    (aIsLarger ? mInputA : mInputB).expression(varyingWire);
+  const WireExpression smaller =
+    (aIsLarger ? mInputB : mInputA).expression(varyingWire);
+  larger.domain = larger.nonlinear || smaller.nonlinear
+                    ? Range(varyingWire.get(), varyingWire.get())
+                    : LessOrEqual::solveInequality(smaller, larger);
+  return larger;
+}
+
+void Max::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::MAX, mInputA, mInputB, &mMaximum);
+}
+
+void Max::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mInputA);
+  inputs.push_back(&mInputB);
+}
+
+void Max::writeName(NameWriter& name) const
+{
+  name.text("max(");
+  name.wire(mInputA);
+  name.text(", ");
+  name.wire(mInputB);
+  name.text(")");
+}
+
+}}
@@ -0,0 +1,47 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "IOperation.h"
+#include "IWire.h"
+
+namespace common { namespace constraints {
+
+/** Models the larger of two wires.
+
+    The expression of the output is the expression of the input that
+    currently has the larger value, so a range derived through it holds as
+    long as that input stays the larger one.
+ */
+class Max : public IOperation
+{
+public:
+  virtual ~Max(){};
+
+  virtual std::string dump(unsigned int indentationLevel) const override;
+  virtual std::string getShortDescription() const override;
+
+private:
+  Max(const Max&) = delete;
+  void operator=(const Max&) = delete;
+  Max(IWire& inputA, IWire& inputB, IWire& maximum);
+
+  virtual Result propagateValue() override;
+  virtual Range range(const IWire& wire) const override;
+  virtual WireExpression expression(const IWire& variable) const override;
+  virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
+
+private:
+  IWire& mInputA;
+  IWire& mInputB;
+  IWire& mMaximum;
+
+  // Allow network factory functions to create maximum objects
+  friend class Network;
+  friend class MaxTest;
+};
+
+}}
@@ -0,0 +1,65 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "MemoryResource.h"
+
+#include <new>
+
+namespace {
+
+using namespace common::constraints;
+
+class NewDeleteResource : public MemoryResource
+{
+protected:
+  virtual void* doAllocate(std::size_t bytes, std::size_t) override
+  {
+    // Arena blocks never need more than the fundamental alignment
+    return ::operator new(bytes);
+  }
+
+  virtual void doDeallocate(void* pointer, std::size_t, std::size_t) override
+  {
+    ::operator delete(pointer);
+  }
+};
+
+class NullResource : public MemoryResource
+{
+protected:
+  virtual void* doAllocate(std::size_t, std::size_t) override
+  {
+    return nullptr;
+  }
+
+  virtual void doDeallocate(void*, std::size_t, std::size_t) override {}
+};
+
+}
+
+namespace common { namespace constraints {
+
+void* MemoryResource::allocate(std::size_t bytes, std::size_t alignment)
+{
+  return doAllocate(bytes, alignment);
+}
+
+void MemoryResource::deallocate(void* pointer,
+                                std::size_t bytes,
+                                std::size_t alignment)
+{
+  doDeallocate(pointer, bytes, alignment);
+}
+
+MemoryResource& MemoryResource::getDefault()
+{
+  static NewDeleteResource resource;
+  return resource;
+}
+
+MemoryResource& MemoryResource::getNull()
+{
+  static NullResource resource;
+  return resource;
+}
+
+}}
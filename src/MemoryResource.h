@@ -0,0 +1,40 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include <cstddef>
+
+namespace common { namespace constraints {
+
+/** Source of raw memory for a Network, modeled after
+    std::pmr::memory_resource, which is not available on all of the targeted
+    platforms.
+
+    \see \ref Arena
+ */
+class MemoryResource
+{
+public:
+  virtual ~MemoryResource() {}
+
+  /** Allocates memory with at least the given size and alignment.
+      \return the memory, or null if the resource is exhausted
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment);
+  /** Returns memory obtained from allocate with the same size and alignment.
+   */
+  void deallocate(void* pointer, std::size_t bytes, std::size_t alignment);
+
+  /** Gets a resource using the global operator new and delete. */
+  static MemoryResource& getDefault();
+  /** Gets a resource that is always exhausted, for arenas that must not
+      allocate beyond their initial buffer.
+   */
+  static MemoryResource& getNull();
+
+protected:
+  virtual void* doAllocate(std::size_t bytes, std::size_t alignment) = 0;
+  virtual void
+  doDeallocate(void* pointer, std::size_t bytes, std::size_t alignment) = 0;
+};
+
+}}
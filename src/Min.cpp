@@ -0,0 +1,106 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Min.h"
+
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <assert.h>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+std::string Min::dump(unsigned int indentationLevel) const
+{
+  std::ostringstream s;
+  s << std::string(indentationLevel * 2, ' ') << getShortDescription()
+    << std::endl;
+  s << mMinimum.dump(indentationLevel + 1);
+  return s.str();
+}
+
+std::string Min::getShortDescription() const
+{
+  std::ostringstream name;
+  name << "min(" << mInputA.getShortDescription() << ", "
+       << mInputB.getShortDescription() << ")";
+  return name.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+Min::Min(IWire& inputA, IWire& inputB, IWire& minimum)
+  : mInputA(inputA)
+  , mInputB(inputB)
+  , mMinimum(minimum)
+{
+  connect(mInputA);
+  connect(mInputB);
+  drive(mMinimum);
+  bool valid = propagateValue();
+  if (getNetwork(mInputA).isVerifyingSoundness())
+  {
+    assert(valid);
+  }
+}
+
+Result Min::propagateValue()
+{
+  // The chain of operations is added by the network if propagation fails
+  const Value a = mInputA.get();
+  const Value b = mInputB.get();
+  return mMinimum.set(a <= b ? a : b);
+}
+
+Range Min::range(const IWire& varyingWire) const
+{
+  // The relations downstream restrict the minimum. Its expression keeps the
+  // varying wire where the smaller input stays the smaller.
+  return mMinimum.range(varyingWire);
+}
+
+std::string Min::getErrorMessage() const
+{
+  std::ostringstream s;
+  s << getName() << " would fail because ";
+  return s.str();
+}
+
+WireExpression Min::expression(const IWire& varyingWire) const
+{
+  // Linear in the input that is currently the smaller, as long as it stays
+  // the smaller. If that cannot be solved, only the current value is known.
+  const bool aIsSmaller = mInputA.get() <= mInputB.get();
+  WireExpression smaller =
+    (aIsSmaller ? mInputA : mInputB).expression(varyingWire);
+  const WireExpression larger =
+    (aIsSmaller ? mInputB : mInputA).expression(varyingWire);
+  smaller.domain = smaller.nonlinear || larger.nonlinear
+                     ? Range(varyingWire.get(), varyingWire.get())
+                     : LessOrEqual::solveInequality(smaller, larger);
+  return smaller;
+}
+
+void Min::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::MIN, mInputA, mInputB, &mMinimum);
+}
+
+void Min::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mInputA);
+  inputs.push_back(&mInputB);
+}
+
+void Min::writeName(NameWriter& name) const
+{
+  name.text("min(");
+  name.wire(mInputA);
+  name.text(", ");
+  name.wire(mInputB);
+  name.text(")");
+}
+
+}}
@@ -27,13 +27,6 @@ std::string Multiplication::getShortDescription() const
   return name.str();
 }
 
-std::string Multiplication::getName() const
-{
-  std::ostringstream name;
-  name << "(" << mFactorA.getName() << ") * (" << mFactorB.getName() << ")";
-  return name.str();
-}
-
 // ----------------------------------------------------------------------------
 // Private functions
 
@@ -54,9 +47,8 @@ Multiplication::Multiplication(IWire& factorA, IWire& factorB, IWire& product)
 
 Result Multiplication::propagateValue()
 {
-  Result r = mProduct.set(mFactorA.get() * mFactorB.get());
-  r.push(this);
-  return r;
+  // The chain of operations is added by the network if propagation fails
+  return mProduct.set(mFactorA.get() * mFactorB.get());
 }
 
 Range Multiplication::range(const IWire& varyingWire) const
@@ -77,4 +69,24 @@ WireExpression Multiplication::expression(const IWire& varyingWire) const
   return mFactorA.expression(varyingWire) * mFactorB.expression(varyingWire);
 }
 
+void Multiplication::compile(CompiledNetwork& compiled) const
+{
+  compileAs(compiled, CompiledNetwork::MULTIPLY, mFactorA, mFactorB, &mProduct);
+}
+
+void Multiplication::appendInputs(Inputs& inputs) const
+{
+  inputs.push_back(&mFactorA);
+  inputs.push_back(&mFactorB);
+}
+
+void Multiplication::writeName(NameWriter& name) const
+{
+  name.text("(");
+  name.wire(mFactorA);
+  name.text(") * (");
+  name.wire(mFactorB);
+  name.text(")");
+}
+
 }}
@@ -15,7 +15,6 @@ public:
 
   virtual std::string dump(unsigned int indentationLevel) const override;
   virtual std::string getShortDescription() const override;
-  virtual std::string getName() const override;
 
 private:
   Multiplication(const Multiplication&) = delete;
@@ -26,6 +25,9 @@ private:
   virtual Range range(const IWire& wire) const override;
   virtual WireExpression expression(const IWire& variable) const override;
   virtual std::string getErrorMessage() const override;
+  virtual void compile(CompiledNetwork& compiled) const override;
+  virtual void appendInputs(Inputs& inputs) const override;
+  virtual void writeName(NameWriter& name) const override;
 
 private:
   IWire& mFactorA;
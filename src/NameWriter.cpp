@@ -0,0 +1,105 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "NameWriter.h"
+
+#include "IOperation.h"
+#include "Wire.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace common { namespace constraints {
+
+void NameWriter::text(const char* text)
+{
+  mPending.push_back(Part{Part::TEXT, text, Value(0)});
+}
+
+void NameWriter::value(Value value)
+{
+  mPending.push_back(Part{Part::VALUE, nullptr, value});
+}
+
+void NameWriter::wire(const IWire& wire)
+{
+  mPending.push_back(Part{Part::WIRE, &wire, Value(0)});
+}
+
+void NameWriter::operation(const IOperation& operation)
+{
+  mPending.push_back(Part{Part::OPERATION, &operation, Value(0)});
+}
+
+std::string NameWriter::getName(const IOperation& operation)
+{
+  std::ostringstream s;
+  NameWriter writer;
+  writer.expand(operation);
+  writer.write(s);
+  return s.str();
+}
+
+std::string NameWriter::getName(const Wire& wire)
+{
+  std::ostringstream s;
+  NameWriter writer;
+  writer.wire(wire);
+  writer.write(s);
+  return s.str();
+}
+
+// ----------------------------------------------------------------------------
+// Private functions
+
+void NameWriter::expand(const IOperation& operation)
+{
+  const std::size_t first = mPending.size();
+  operation.writeName(*this);
+  std::reverse(mPending.begin() + first, mPending.end());
+}
+
+void NameWriter::write(std::ostream& s)
+{
+  while (!mPending.empty())
+  {
+    const Part part = mPending.back();
+    mPending.pop_back();
+    switch (part.kind)
+    {
+    case Part::TEXT:
+      s << static_cast<const char*>(part.pointer);
+      break;
+    case Part::VALUE:
+      s << part.value;
+      break;
+    case Part::WIRE:
+    {
+      const IWire& other = *static_cast<const IWire*>(part.pointer);
+      if (other.asWire() == nullptr)
+      {
+        s << other.getName();
+        break;
+      }
+      const Wire& wire = *other.asWire();
+      if (wire.mName != nullptr && *wire.mName != '\0')
+      {
+        s << wire.mName;
+        if (wire.mDriver != nullptr)
+        {
+          s << ": ";
+        }
+      }
+      if (wire.mDriver != nullptr)
+      {
+        expand(*wire.mDriver);
+      }
+      break;
+    }
+    case Part::OPERATION:
+      expand(*static_cast<const IOperation*>(part.pointer));
+      break;
+    }
+  }
+}
+
+}}
@@ -0,0 +1,72 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include "Value.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace common { namespace constraints {
+
+class IOperation;
+class IWire;
+class Wire;
+
+/** Puts together the names of wires and operations without recursion.
+
+    An operation describes its name as a sequence of parts, some of which
+    are the names of its input wires. The writer expands those on an
+    explicit stack, so the depth of the network costs no native stack even
+    for long chains of operations.
+
+    \see \ref IOperation::writeName
+ */
+class NameWriter
+{
+public:
+  /** Appends literal text, which must outlive the writer. */
+  void text(const char* text);
+  /** Appends a number. */
+  void value(Value value);
+  /** Appends the name of a wire, including the name of its driver. */
+  void wire(const IWire& wire);
+  /** Appends the name of another operation. */
+  void operation(const IOperation& operation);
+
+  /** \return the name of an operation in terms of its inputs */
+  static std::string getName(const IOperation& operation);
+  /** \return the name of a wire in terms of the inputs of its driver */
+  static std::string getName(const Wire& wire);
+
+private:
+  struct Part
+  {
+    enum Kind
+    {
+      TEXT,
+      VALUE,
+      WIRE,
+      OPERATION
+    };
+
+    Kind kind;
+    const void* pointer;
+    Value value;
+  };
+
+  NameWriter() = default;
+  NameWriter(const NameWriter&) = delete;
+  void operator=(const NameWriter&) = delete;
+
+  /** Pushes the parts of an operation, so that the first is on top. */
+  void expand(const IOperation& operation);
+  /** Writes the parts on the stack until it is empty. */
+  void write(std::ostream& s);
+
+private:
+  /** Parts still to be written, the next one last. */
+  std::vector<Part> mPending;
+};
+
+}}
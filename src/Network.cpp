@@ -2,13 +2,57 @@
 
 #include "Network.h"
 
+#include "Abs.h"
 #include "Addition.h"
+#include "Bounds.h"
+#include "Clamp.h"
+#include "Equal.h"
 #include "LessOrEqual.h"
+#include "LinearCombination.h"
+#include "Max.h"
+#include "Min.h"
 #include "Multiplication.h"
 #include "Wire.h"
 
 #include <algorithm>
-#include <sstream>
+#include <assert.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <unordered_set>
+
+namespace {
+
+using namespace common::constraints;
+
+/** Size of the largest operation created by the factory functions. */
+const std::size_t OPERATION_BYTES = std::max({sizeof(Abs),
+                                              sizeof(Addition),
+                                              sizeof(Bounds),
+                                              sizeof(Clamp),
+                                              sizeof(Equal),
+                                              sizeof(LessOrEqual),
+                                              sizeof(LinearCombination),
+                                              sizeof(Max),
+                                              sizeof(Min),
+                                              sizeof(Multiplication)});
+
+/** Padding an allocation from the arena may need for its alignment. */
+const std::size_t PADDING = alignof(std::max_align_t);
+
+/** Bound on the bucket array of a hash table reserved for the given number
+    of entries. The common standard libraries take at most four pointers per
+    entry, rounded up to a prime or a power of two.
+ */
+std::size_t getBucketBytes(std::size_t entries)
+{
+  return (4 * entries + 32) * sizeof(void*) + PADDING;
+}
+
+}
 
 namespace common { namespace constraints {
 
@@ -18,46 +62,908 @@ Network::Network(bool verifySoundness)
 {
 }
 
-Wire& Network::make(double value)
+Network::Network(bool verifySoundness, MemoryResource& memory)
+  : mArena(memory)
+  , mVerifySoundness(verifySoundness)
 {
-  Wire* wire = new Wire(*this, value);
-  mWires.emplace_back(wire);
-  std::ostringstream name;
-  name << "Wire" << mWires.size();
-  wire->setName(name.str());
-  return *wire;
 }
 
-Wire& Network::make(std::string name, double value)
+Network::Network(bool verifySoundness,
+                 void* buffer,
+                 std::size_t bytes,
+                 const Capacity& capacity)
+  : mArena(buffer, bytes, MemoryResource::getNull())
+  , mCapacity(capacity)
+  , mFixedCapacity(true)
+  , mVerifySoundness(verifySoundness)
 {
-  Wire& w = make(value);
-  w.setName(name);
-  return w;
+  const std::size_t pointers =
+    (4 * capacity.wires + capacity.operations + 2 * capacity.connections)
+    * sizeof(void*);
+  const std::size_t stacks =
+    2 * (capacity.wires + capacity.connections) * sizeof(PendingWire);
+  const std::size_t schedule =
+    (capacity.operations + 1) * sizeof(ScheduledRank);
+  const std::size_t placeholders = sizeof(Wire) + sizeof(LessOrEqual)
+                                   + sizeof(Bounds) + sizeof(Equal)
+                                   + 12 * sizeof(void*) + 6 * PADDING;
+  if (!fits(pointers + stacks + schedule + getBucketBytes(capacity.wires)
+            + getBucketBytes(capacity.operations) + 9 * PADDING
+            + placeholders))
+  {
+    // Keep the placeholders usable, and refuse everything else
+    mExhausted = true;
+    mCapacity = Capacity{0, 0, 0, 0};
+  }
+  // Reserve up front, so that the containers never grow
+  mWires.reserve(mCapacity.wires);
+  mOperations.reserve(mCapacity.operations);
+  mConstants.reserve(mCapacity.wires);
+  mShared.reserve(mCapacity.operations);
+  reserveRank(static_cast<unsigned int>(mCapacity.operations));
+  mRangeStack.reserve(mCapacity.wires);
+  mExpressionStack.reserve(mCapacity.wires + mCapacity.connections);
+  mInputs.reserve(mCapacity.connections);
+  mMarkStack.reserve(2 * mCapacity.wires);
+  mRefreshStack.reserve(mCapacity.wires + mCapacity.connections);
+  mRefreshInputs.reserve(mCapacity.connections);
+  mSpareWire = create<Wire>(*this, Value(0));
+  mSpareRelation = create<LessOrEqual>(*mSpareWire, *mSpareWire);
+  mSpareBounds = create<Bounds>(*mSpareWire, Value(0), Value(0));
+  mSpareEqual = create<Equal>(*mSpareWire, *mSpareWire, Value(0));
+}
+
+Network::~Network()
+{
+  // The arena releases the memory, but the objects must be destroyed first
+  for (auto operation : mOperations)
+  {
+    operation->~IOperation();
+  }
+  for (auto wire : mWires)
+  {
+    wire->~Wire();
+  }
+  if (mSpareRelation != nullptr)
+  {
+    mSpareRelation->~LessOrEqual();
+    mSpareBounds->~Bounds();
+    mSpareEqual->~Equal();
+    mSpareWire->~Wire();
+  }
+}
+
+Wire& Network::make(Value value)
+{
+  if (!take(1, 0, 0))
+  {
+    return *mSpareWire;
+  }
+  Wire& wire = createWire(value);
+  char name[32];
+  std::snprintf(name,
+                sizeof(name),
+                "Wire%lu",
+                static_cast<unsigned long>(mWires.size()));
+  wire.setName(name, std::strlen(name));
+  return wire;
+}
+
+Wire& Network::make(std::string name, Value value)
+{
+  return make(name.c_str(), value);
+}
+
+Wire& Network::make(const char* name, Value value)
+{
+  if (!take(1, 0, 0))
+  {
+    return *mSpareWire;
+  }
+  Wire& wire = createWire(value);
+  wire.setName(name, std::strlen(name));
+  return wire;
+}
+
+Wire& Network::constant(Value value)
+{
+  auto found = mConstants.find(static_cast<double>(value));
+  if (found != mConstants.end())
+  {
+    return *found->second;
+  }
+  if (!take(1, 0, 0))
+  {
+    return *mSpareWire;
+  }
+  Wire& wire = createWire(value);
+  char name[32];
+  std::snprintf(name, sizeof(name), "%g", static_cast<double>(value));
+  wire.setName(name, std::strlen(name));
+  wire.mConstant = true;
+  // NaN never compares equal to itself, so it is not pooled
+  if (value == value)
+  {
+    mConstants.emplace(static_cast<double>(value), &wire);
+  }
+  return wire;
 }
 
 Wire& Network::add(Wire& termA, Wire& termB)
 {
-  Wire* sum = new Wire(*this);
-  mWires.emplace_back(sum);
-  mOperations.emplace_back(new Addition(termA, termB, *sum));
-  return *sum;
+  if (termA.mConstant && termB.mConstant)
+  {
+    return constant(termA.mValue + termB.mValue);
+  }
+  const Subexpression subexpression('+', termA, termB);
+  if (Wire* shared = findShared(subexpression))
+  {
+    return *shared;
+  }
+  if (!take(1, 1, 2))
+  {
+    return *mSpareWire;
+  }
+  Wire& sum = createWire(0.0);
+  addOperation(create<Addition>(termA, termB, sum));
+  if (mSharingSubexpressions)
+  {
+    mShared.emplace(subexpression, &sum);
+  }
+  return sum;
 }
 
 Wire& Network::multiply(Wire& factorA, Wire& factorB)
 {
-  Wire* product = new Wire(*this);
-  mWires.emplace_back(product);
-  mOperations.emplace_back(new Multiplication(factorA, factorB, *product));
-  return *product;
+  if (factorA.mConstant && factorB.mConstant)
+  {
+    return constant(factorA.mValue * factorB.mValue);
+  }
+  const Subexpression subexpression('*', factorA, factorB);
+  if (Wire* shared = findShared(subexpression))
+  {
+    return *shared;
+  }
+  if (!take(1, 1, 2))
+  {
+    return *mSpareWire;
+  }
+  Wire& product = createWire(0.0);
+  addOperation(create<Multiplication>(factorA, factorB, product));
+  if (mSharingSubexpressions)
+  {
+    mShared.emplace(subexpression, &product);
+  }
+  return product;
+}
+
+Wire& Network::linearCombination(
+  const std::vector<std::pair<Wire*, Value>>& terms,
+  Value constant)
+{
+  std::vector<LinearCombination::Term> inputs;
+  inputs.reserve(terms.size());
+  for (auto& term : terms)
+  {
+    if (term.first->mConstant)
+    {
+      constant = constant + term.second * term.first->mValue;
+    }
+    else
+    {
+      inputs.push_back(LinearCombination::Term{term.first, term.second});
+    }
+  }
+  if (inputs.empty())
+  {
+    return this->constant(constant);
+  }
+  if (!take(1, 1, inputs.size(), inputs.size()))
+  {
+    return *mSpareWire;
+  }
+  Wire& sum = createWire(0.0);
+  LinearCombination* combination = create<LinearCombination>(
+    mArena, inputs.data(), inputs.size(), constant, sum);
+  sum.mCombination = combination;
+  addOperation(combination);
+  return sum;
+}
+
+Wire& Network::minimum(Wire& inputA, Wire& inputB)
+{
+  if (inputA.mConstant && inputB.mConstant)
+  {
+    return constant(inputA.mValue <= inputB.mValue ? inputA.mValue
+                                                   : inputB.mValue);
+  }
+  if (!take(1, 1, 2))
+  {
+    return *mSpareWire;
+  }
+  Wire& result = createWire(0.0);
+  addOperation(create<Min>(inputA, inputB, result));
+  return result;
+}
+
+Wire& Network::maximum(Wire& inputA, Wire& inputB)
+{
+  if (inputA.mConstant && inputB.mConstant)
+  {
+    return constant(inputA.mValue >= inputB.mValue ? inputA.mValue
+                                                   : inputB.mValue);
+  }
+  if (!take(1, 1, 2))
+  {
+    return *mSpareWire;
+  }
+  Wire& result = createWire(0.0);
+  addOperation(create<Max>(inputA, inputB, result));
+  return result;
+}
+
+Wire& Network::absolute(Wire& input)
+{
+  if (input.mConstant)
+  {
+    return constant(input.mValue < 0 ? -input.mValue : input.mValue);
+  }
+  if (!take(1, 1, 1))
+  {
+    return *mSpareWire;
+  }
+  Wire& result = createWire(0.0);
+  addOperation(create<Abs>(input, result));
+  return result;
+}
+
+Wire& Network::clamp(Wire& input, Value lower, Value upper)
+{
+  if (input.mConstant)
+  {
+    const Value value = input.mValue;
+    return constant(value < lower ? lower : (upper < value ? upper : value));
+  }
+  if (!take(1, 1, 1))
+  {
+    return *mSpareWire;
+  }
+  Wire& result = createWire(0.0);
+  addOperation(create<Clamp>(input, lower, upper, result));
+  return result;
 }
 
 LessOrEqual& Network::lessOrEqual(IWire& left, IWire& right)
 {
-  LessOrEqual* pointer = new LessOrEqual(left, right);
-  mOperations.emplace_back(pointer);
+  if (!take(0, 1, 2))
+  {
+    return *mSpareRelation;
+  }
+  LessOrEqual* pointer = create<LessOrEqual>(left, right);
+  addOperation(pointer);
+  return *pointer;
+}
+
+Bounds& Network::bounds(IWire& wire, Value lower, Value upper)
+{
+  if (!take(0, 1, 1))
+  {
+    return *mSpareBounds;
+  }
+  Bounds* pointer = create<Bounds>(wire, lower, upper);
+  addOperation(pointer);
   return *pointer;
 }
 
+Equal& Network::equal(IWire& left, IWire& right, Value tolerance)
+{
+  if (!take(0, 1, 2))
+  {
+    return *mSpareEqual;
+  }
+  Equal* pointer = create<Equal>(left, right, tolerance);
+  addOperation(pointer);
+  return *pointer;
+}
+
+Result Network::setMany(
+  const std::vector<std::pair<Wire*, Value>>& values)
+{
+  return setMany(values.data(), values.size());
+}
+
+Result Network::setMany(const std::pair<Wire*, Value>* values,
+                        std::size_t count)
+{
+  assert(!mPropagating);
+  const std::pair<Wire*, Value>* const end = values + count;
+  for (auto value = values; value != end; ++value)
+  {
+    if (value->first->mConstant && value->second != value->first->mValue)
+    {
+      Result result(false);
+      result.rejectConstant(value->first);
+      return result;
+    }
+  }
+  beginPropagation();
+  CONSTRAINTS_STATS(++mStats.propagations;)
+  ++mTransaction;
+  mRecordingChanges = true;
+
+  std::size_t lowestRank = std::numeric_limits<std::size_t>::max();
+  for (auto value = values; value != end; ++value)
+  {
+    Wire& wire = *value->first;
+    recordChange(wire);
+    wire.mValue = value->second;
+    schedule(wire);
+    lowestRank = std::min<std::size_t>(lowestRank, wire.mRank);
+  }
+
+  Result result = evaluateScheduled(lowestRank);
+  if (!result)
+  {
+    for (Wire* wire = mChanged; wire != nullptr; wire = wire->mNextChanged)
+    {
+      wire->mValue = wire->mSavedValue;
+      // The consumers may have seen the value that is now undone
+      for (auto operation : wire->mOperations)
+      {
+        operation->mMissedUpdate = true;
+      }
+    }
+    ++mValueEpoch;
+  }
+  mChanged = nullptr;
+  mRecordingChanges = false;
+  return result;
+}
+
+CompiledNetwork Network::compile() const
+{
+  std::vector<const Wire*> wires(mWires.begin(), mWires.end());
+  std::vector<const IOperation*> operations(mOperations.begin(),
+                                            mOperations.end());
+  return compile(wires, operations);
+}
+
+CompiledNetwork Network::compileDownstream(const Wire& root) const
+{
+  std::vector<const Wire*> wires;
+  std::vector<const IOperation*> operations;
+  // Placeholders of an exhausted network are not part of any snapshot
+  if (&root == mSpareWire)
+  {
+    return compile(wires, operations);
+  }
+  wires.push_back(&root);
+  std::unordered_set<const IOperation*> visited;
+  const unsigned long long walk = ++mRangeWalk;
+  root.mRangeWalk = walk;
+  auto add = [&](const Wire* wire) {
+    if (wire->mRangeWalk != walk)
+    {
+      wire->mRangeWalk = walk;
+      wires.push_back(wire);
+    }
+  };
+  for (std::size_t next = 0; next < wires.size(); ++next)
+  {
+    for (auto operation : wires[next]->mOperations)
+    {
+      if (!visited.insert(operation).second)
+      {
+        continue;
+      }
+      operations.push_back(operation);
+      mInputs.clear();
+      operation->appendInputs(mInputs);
+      for (auto input : mInputs)
+      {
+        add(static_cast<const Wire*>(input));
+      }
+      if (operation->mOutput != nullptr)
+      {
+        add(static_cast<const Wire*>(operation->mOutput));
+      }
+    }
+  }
+  return compile(wires, operations);
+}
+
+std::unordered_map<const Wire*, Range> Network::computeAllRanges() const
+{
+  const CompiledNetwork tape = compile();
+  std::vector<bool> solved;
+  const std::vector<Range> ranges =
+    computeRanges(tape, std::vector<bool>(tape.getWireCount(), true), solved);
+  std::unordered_map<const Wire*, Range> byWire;
+  for (auto& entry : tape.mIndices)
+  {
+    if (solved[entry.second])
+    {
+      byWire.emplace(static_cast<const Wire*>(entry.first),
+                     ranges[entry.second]);
+    }
+  }
+  return byWire;
+}
+
+std::vector<Range> Network::computeRanges(const CompiledNetwork& tape,
+                                          const std::vector<bool>& wanted,
+                                          std::vector<bool>& solved) const
+{
+  typedef CompiledNetwork::Index Index;
+  const Index NONE = CompiledNetwork::NONE;
+  const std::size_t wireCount = tape.getWireCount();
+  const std::size_t operationCount = tape.getOperationCount();
+
+  std::vector<const Wire*> wires(wireCount, nullptr);
+  for (auto& entry : tape.mIndices)
+  {
+    wires[entry.second] = static_cast<const Wire*>(entry.first);
+  }
+
+  // Calls visit(wire, coefficient) for every input of an operation
+  auto visitInputs = [&tape](Index operation, auto visit) {
+    if (tape.mOpcodes[operation] == CompiledNetwork::LINEAR)
+    {
+      for (Index term = tape.mTermOffsets[operation];
+           term < tape.mTermOffsets[operation + 1];
+           ++term)
+      {
+        visit(tape.mTermWires[term], tape.mTermCoefficients[term]);
+      }
+    }
+    else
+    {
+      visit(tape.mOperandsA[operation], 1.0);
+      visit(tape.mOperandsB[operation], 1.0);
+    }
+  };
+
+  // A window lower <= q <= upper on a quantity q: right - left for
+  // comparisons and equalities, the single operand of bounds, or the value
+  // of a wire that several windows have been folded into
+  struct Window
+  {
+    double value;
+    Value lower;
+    Value upper;
+  };
+  // The coefficient of the quantity of a window with respect to a wire
+  struct Term
+  {
+    Index window;
+    double coefficient;
+  };
+  std::vector<Window> windows;
+  // Per window, the number of terms held by wires that are not finished.
+  // Undriven wires that no operation reads cannot be upstream of another
+  // wire, so their terms are not counted.
+  std::vector<std::size_t> holders;
+  std::vector<bool> counted(wireCount, false);
+  for (Index wire = 0; wire < wireCount; ++wire)
+  {
+    counted[wire] = tape.mDrivers[wire] != NONE;
+    for (Index consumer = tape.mConsumerOffsets[wire];
+         consumer < tape.mConsumerOffsets[wire + 1];
+         ++consumer)
+    {
+      counted[wire] = counted[wire]
+                      || tape.mOutputs[tape.mConsumers[consumer]] != NONE;
+    }
+  }
+  // Per window, scratch space for merging the terms of one wire
+  std::vector<Index> positions;
+  std::vector<std::vector<Term>> terms(wireCount);
+  // Wires upstream of any relation, even if the relation holds for all of
+  // their values
+  std::vector<bool> constrained(wireCount, false);
+  // Wires that reach a piecewise operation, or both factors of a
+  // multiplication, upstream of a relation are solved through expressions
+  // instead
+  std::vector<bool> expressed(wireCount, false);
+  std::vector<Range> ranges(wireCount, Range::FULL);
+  solved = wanted;
+
+  auto addWindow = [&](double value, Value lower, Value upper) {
+    windows.push_back(Window{value, lower, upper});
+    holders.push_back(0);
+    positions.push_back(NONE);
+    return static_cast<Index>(windows.size() - 1);
+  };
+  auto addTerm = [&](Index wire, Index window, double coefficient) {
+    terms[wire].push_back(Term{window, coefficient});
+    constrained[wire] = true;
+    if (counted[wire])
+    {
+      ++holders[window];
+    }
+  };
+  auto solve = [&](const Term& term, Index wire) {
+    // The quantity is k*x + m, where x is the wire
+    const Window& window = windows[term.window];
+    const double k = term.coefficient;
+    const double m = window.value - k * tape.mValues[wire];
+    return Bounds::solve(WireExpression::createLinear(static_cast<Value>(k),
+                                                      static_cast<Value>(m)),
+                         window.lower,
+                         window.upper);
+  };
+
+  // Once all operations reading a wire have passed their terms on, the terms
+  // are merged per window and solved for the range of the wire. The windows
+  // no other wire holds terms of are reached from upstream only through this
+  // wire, so they are folded into one window on its value.
+  auto finish = [&](Index wire) {
+    std::vector<Term>& list = terms[wire];
+    const bool driven = tape.mDrivers[wire] != NONE;
+    if (expressed[wire])
+    {
+      for (auto& term : list)
+      {
+        holders[term.window] -= counted[wire] ? 1 : 0;
+      }
+      std::vector<Term>().swap(list);
+      if (wanted[wire])
+      {
+        bool linear = true;
+        ranges[wire] = rangeDownstream(*wires[wire], *wires[wire], &linear);
+        solved[wire] = linear;
+        if (!linear)
+        {
+          ranges[wire] = Range::FULL;
+        }
+      }
+      return;
+    }
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < list.size(); ++i)
+    {
+      Index& position = positions[list[i].window];
+      if (position == NONE)
+      {
+        position = static_cast<Index>(count);
+        list[count++] = list[i];
+      }
+      else
+      {
+        list[position].coefficient += list[i].coefficient;
+        holders[list[i].window] -= counted[wire] ? 1 : 0;
+      }
+    }
+    list.resize(count);
+
+    Range folded;
+    bool folding = false;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < list.size(); ++i)
+    {
+      const Term term = list[i];
+      positions[term.window] = NONE;
+      const Range range = solve(term, wire);
+      ranges[wire] = Range::intersect(ranges[wire], range);
+      if (driven && holders[term.window] == 1)
+      {
+        --holders[term.window];
+        folded = Range::intersect(folded, range);
+        folding = true;
+      }
+      else
+      {
+        list[kept++] = term;
+      }
+    }
+    list.resize(kept);
+    if (folding && folded != Range::FULL)
+    {
+      addTerm(wire,
+              addWindow(tape.mValues[wire], folded.lower, folded.upper),
+              1.0);
+    }
+  };
+
+  // Marks the wires upstream of both factors of a multiplication
+  std::vector<std::size_t> reachedA(wireCount, 0);
+  std::vector<std::size_t> reachedB(wireCount, 0);
+  std::size_t walk = 0;
+  std::vector<Index> pending;
+  auto walkUpstream =
+    [&](Index start, std::vector<std::size_t>& reached, auto visit) {
+      reached[start] = walk;
+      pending.assign(1, start);
+      while (!pending.empty())
+      {
+        const Index wire = pending.back();
+        pending.pop_back();
+        visit(wire);
+        if (tape.mDrivers[wire] != NONE)
+        {
+          visitInputs(tape.mDrivers[wire], [&](Index input, double) {
+            if (reached[input] != walk)
+            {
+              reached[input] = walk;
+              pending.push_back(input);
+            }
+          });
+        }
+      }
+    };
+
+  // Reverse sweep: every wire receives the coefficients of the windows
+  // downstream of it from the operations reading it, and is finished when
+  // its driver is reached
+  beginQuery();
+  for (Index operation = static_cast<Index>(operationCount); operation-- > 0;)
+  {
+    const CompiledNetwork::Opcode opcode = tape.mOpcodes[operation];
+    const Index a = tape.mOperandsA[operation];
+    const Index b = tape.mOperandsB[operation];
+    const double va = tape.mValues[a];
+    const double vb = tape.mValues[b];
+    const Index output = tape.mOutputs[operation];
+    if (output == NONE)
+    {
+      if (opcode == CompiledNetwork::BOUNDS)
+      {
+        addTerm(a,
+                addWindow(va,
+                          static_cast<Value>(tape.mLowerLimits[operation]),
+                          static_cast<Value>(tape.mUpperLimits[operation])),
+                1.0);
+        continue;
+      }
+      const Index window =
+        opcode == CompiledNetwork::EQUAL
+          ? addWindow(vb - va,
+                      static_cast<Value>(tape.mLowerLimits[operation]),
+                      static_cast<Value>(tape.mUpperLimits[operation]))
+          : addWindow(vb - va, 0, Range::POSITIVE_INFINITY);
+      addTerm(b, window, 1.0);
+      addTerm(a, window, -1.0);
+      continue;
+    }
+
+    finish(output);
+    std::vector<Term> list;
+    list.swap(terms[output]);
+    if (!constrained[output])
+    {
+      continue;
+    }
+    visitInputs(operation, [&](Index wire, double) {
+      constrained[wire] = true;
+      expressed[wire] = expressed[wire] || expressed[output];
+    });
+    if (expressed[output])
+    {
+      continue;
+    }
+    for (auto& term : list)
+    {
+      --holders[term.window];
+    }
+    switch (opcode)
+    {
+    case CompiledNetwork::MIN:
+    case CompiledNetwork::MAX:
+    case CompiledNetwork::ABS:
+    case CompiledNetwork::CLAMP:
+      // The active piece only holds for part of the values of the inputs
+      expressed[a] = true;
+      expressed[b] = true;
+      break;
+    case CompiledNetwork::MULTIPLY:
+      ++walk;
+      walkUpstream(a, reachedA, [](Index) {});
+      walkUpstream(b, reachedB, [&](Index wire) {
+        if (reachedA[wire] == walk)
+        {
+          expressed[wire] = true;
+        }
+      });
+      for (auto& term : list)
+      {
+        addTerm(a, term.window, term.coefficient * vb);
+        addTerm(b, term.window, term.coefficient * va);
+      }
+      break;
+    default:
+      visitInputs(operation, [&](Index wire, double coefficient) {
+        for (auto& term : list)
+        {
+          addTerm(wire, term.window, term.coefficient * coefficient);
+        }
+      });
+      break;
+    }
+  }
+  for (Index wire = 0; wire < wireCount; ++wire)
+  {
+    if (tape.mDrivers[wire] == NONE)
+    {
+      finish(wire);
+    }
+  }
+  return ranges;
+}
+
+std::size_t Network::getReservedBytes() const
+{
+  return mArena.getReservedBytes();
+}
+
+std::size_t Network::getUsedBytes() const
+{
+  return mArena.getUsedBytes();
+}
+
+void Network::setExpressionCaching(bool enabled)
+{
+  mCachingExpressions = enabled;
+}
+
+void Network::setLazyEvaluation(bool enabled)
+{
+  assert(!mPropagating);
+  if (!enabled)
+  {
+    for (auto wire : mWires)
+    {
+      if (wire->mDirty)
+      {
+        refresh(*wire);
+      }
+    }
+  }
+  mLazy = enabled;
+}
+
+void Network::pin(Wire& wire)
+{
+  wire.mPinned = true;
+  if (wire.mDriver != nullptr && !wire.mDriver->mObserved)
+  {
+    if (wire.mDirty)
+    {
+      refresh(wire);
+    }
+    observe(*wire.mDriver);
+  }
+}
+
+void Network::optimize()
+{
+  assert(!mPropagating);
+  // Wires of removed operations keep their values, which must be current
+  for (auto wire : mWires)
+  {
+    if (wire->mDirty)
+    {
+      refresh(*wire);
+    }
+  }
+
+  // Nothing downstream of a removed operation is kept, so its output is left
+  // without consumers
+  for (auto wire : mWires)
+  {
+    if (wire->mDriver != nullptr && isRemovable(*wire->mDriver))
+    {
+      wire->mDriver = nullptr;
+      wire->mCombination = nullptr;
+      wire->mRank = 0;
+    }
+  }
+  std::size_t kept = 0;
+  for (auto operation : mOperations)
+  {
+    if (!isRemovable(*operation))
+    {
+      mOperations[kept++] = operation;
+      continue;
+    }
+    mInputs.clear();
+    operation->appendInputs(mInputs);
+    for (auto input : mInputs)
+    {
+      operation->disconnect(*input);
+    }
+    operation->~IOperation();
+  }
+  mOperations.resize(kept);
+  for (auto shared = mShared.begin(); shared != mShared.end();)
+  {
+    shared = shared->second->mDriver == nullptr ? mShared.erase(shared)
+                                                : std::next(shared);
+  }
+
+  // Operations are in the order they were created, so a chain of
+  // combinations is merged into its last one in a single pass
+  for (auto operation : mOperations)
+  {
+    const Wire* output =
+      operation->mOutput != nullptr ? operation->mOutput->asWire() : nullptr;
+    if (output == nullptr || output->mDetached
+        || output->mCombination != operation)
+    {
+      continue;
+    }
+    LinearCombination& combination = *output->mCombination;
+    for (std::size_t index = 0; index < combination.mInputs.size();)
+    {
+      Wire& input = *static_cast<Wire*>(combination.mInputs[index].wire);
+      if (!isMergeable(input)
+          || !take(0, 0, input.mCombination->mInputs.size()))
+      {
+        ++index;
+        continue;
+      }
+      // The last input takes the place of the merged one
+      combination.absorb(*input.mCombination);
+      input.mDetached = true;
+      input.mRelations.clear();
+    }
+  }
+
+  unsigned int highestRank = 0;
+  for (auto operation : mOperations)
+  {
+    highestRank = std::max(highestRank, operation->mRank);
+  }
+  mSchedule.resize(mOperations.empty() ? 0 : highestRank + 1);
+}
+
+void Network::indexRelations()
+{
+  assert(mCapacity.wires == std::numeric_limits<std::size_t>::max());
+  if (mIndexingRelations)
+  {
+    return;
+  }
+  mIndexingRelations = true;
+  for (auto operation : mOperations)
+  {
+    if (operation->mOutput == nullptr)
+    {
+      indexRelation(*operation);
+    }
+  }
+}
+
+const IOperation::Relations& Network::getRelations(const Wire& wire) const
+{
+  assert(mIndexingRelations);
+  return wire.mRelations;
+}
+
+void Network::setSubexpressionSharing(bool enabled)
+{
+  mSharingSubexpressions = enabled;
+}
+
+bool Network::isCapacityExhausted() const
+{
+  return mExhausted;
+}
+
+NetworkStats Network::stats() const
+{
+  return mStats;
+}
+
+void Network::resetStats()
+{
+  mStats = NetworkStats();
+}
+
+void Network::setTraceBuffer(TraceBuffer* buffer)
+{
+  mTrace = buffer;
+}
+
 bool Network::isVerifyingSoundness()
 {
   return mVerifySoundness;
@@ -67,8 +973,679 @@ bool Network::activateSoundnessVerification()
 {
   mVerifySoundness = true;
   return std::all_of(
-    mWires.begin(), mWires.end(), [&](std::unique_ptr<Wire>& w) {
+    mWires.begin(), mWires.end(), [&](Wire* w) {
       return w->propagateValue();
     });
 }
+
+// ----------------------------------------------------------------------------
+// Private members
+
+bool Network::take(std::size_t wires,
+                   std::size_t operations,
+                   std::size_t connections,
+                   std::size_t terms)
+{
+  // The objects with their entries in the constant pool or the shared
+  // subexpressions, a grown connection list per connection, and all that a
+  // linear combination with the given terms takes over its lifetime
+  const std::size_t entry =
+    sizeof(std::pair<const Subexpression, Wire*>) + 4 * sizeof(void*);
+  const std::size_t bytes =
+    wires * (sizeof(Wire) + entry + 2 * PADDING)
+    + operations * (OPERATION_BYTES + entry + 2 * PADDING)
+    + connections
+        * ((2 * mLongestConnectionList + 4) * sizeof(void*) + PADDING)
+    + (terms > 0 ? LinearCombination::getMaxBytes(1, terms) + 3 * PADDING
+                 : 0);
+  if (mExhausted || mUsed.wires + wires > mCapacity.wires
+      || mUsed.operations + operations > mCapacity.operations
+      || mUsed.connections + connections > mCapacity.connections
+      || !fits(bytes))
+  {
+    mExhausted = true;
+    return false;
+  }
+  mUsed.wires += wires;
+  mUsed.operations += operations;
+  mUsed.connections += connections;
+  return true;
+}
+
+Wire& Network::createWire(Value value)
+{
+  Wire* wire = create<Wire>(*this, value);
+  mWires.push_back(wire);
+  return *wire;
+}
+
+bool Network::fits(std::size_t bytes) const
+{
+  return !mFixedCapacity || bytes <= mArena.getAvailableBytes();
+}
+
+const char* Network::copyName(const char* name, std::size_t length)
+{
+  if (mUsed.nameBytes + length + 1 > mCapacity.nameBytes || !fits(length + 1))
+  {
+    mExhausted = true;
+    return nullptr;
+  }
+  mUsed.nameBytes += length + 1;
+  char* copy = static_cast<char*>(mArena.allocate(length + 1, 1));
+  assert(copy != nullptr);
+  std::memcpy(copy, name, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+void Network::addOperation(IOperation* operation)
+{
+  mOperations.push_back(operation);
+  reserveRank(operation->mRank);
+  if (operation->mOutput == nullptr)
+  {
+    observe(*operation);
+    if (mIndexingRelations)
+    {
+      indexRelation(*operation);
+    }
+  }
+}
+
+void Network::observe(IOperation& operation)
+{
+  operation.mObserved = true;
+  const std::size_t base = mMarkStack.size();
+  const IOperation* current = &operation;
+  for (;;)
+  {
+    mInputs.clear();
+    current->appendInputs(mInputs);
+    for (auto input : mInputs)
+    {
+      const Wire* wire = input->asWire();
+      if (wire == nullptr || wire->mDriver == nullptr
+          || wire->mDriver->mObserved)
+      {
+        continue;
+      }
+      // Observed operations are never deferred, so they must be up to date
+      if (wire->mDirty)
+      {
+        refresh(*wire);
+      }
+      wire->mDriver->mObserved = true;
+      mMarkStack.push_back(wire);
+    }
+    if (mMarkStack.size() == base)
+    {
+      return;
+    }
+    current = mMarkStack.back()->mDriver;
+    mMarkStack.pop_back();
+  }
+}
+
+bool Network::isRemovable(const IOperation& operation) const
+{
+  if (operation.mObserved)
+  {
+    return false;
+  }
+  const Wire* output =
+    operation.mOutput != nullptr ? operation.mOutput->asWire() : nullptr;
+  return output == nullptr || !output->mDetached;
+}
+
+bool Network::isMergeable(const Wire& wire) const
+{
+  return wire.mCombination != nullptr && !wire.mDetached && !wire.mPinned
+         && wire.mOperations.size() == 1;
+}
+
+void Network::indexRelation(const IOperation& relation)
+{
+  const std::size_t base = mMarkStack.size();
+  const IOperation* current = &relation;
+  for (;;)
+  {
+    mInputs.clear();
+    current->appendInputs(mInputs);
+    for (auto input : mInputs)
+    {
+      if (input->asWire() == nullptr)
+      {
+        continue;
+      }
+      Wire& wire = *static_cast<Wire*>(input);
+      // Relations are indexed one at a time, so a wire reached through
+      // another path already has the relation last
+      if (!wire.mRelations.empty() && wire.mRelations.back() == &relation)
+      {
+        continue;
+      }
+      wire.mRelations.push_back(&relation);
+      if (wire.mDriver != nullptr)
+      {
+        mMarkStack.push_back(&wire);
+      }
+    }
+    if (mMarkStack.size() == base)
+    {
+      return;
+    }
+    current = mMarkStack.back()->mDriver;
+    mMarkStack.pop_back();
+  }
+}
+
+Network::Subexpression::Subexpression(char kind,
+                                      const Wire& operandA,
+                                      const Wire& operandB)
+  : kind(kind)
+  , first(std::min(&operandA, &operandB, std::less<const Wire*>()))
+  , second(std::max(&operandA, &operandB, std::less<const Wire*>()))
+{
+}
+
+bool Network::Subexpression::operator==(const Subexpression& other) const
+{
+  return kind == other.kind && first == other.first && second == other.second;
+}
+
+std::size_t Network::SubexpressionHash::
+operator()(const Subexpression& subexpression) const
+{
+  std::hash<const Wire*> hash;
+  std::size_t seed = hash(subexpression.first);
+  seed ^= hash(subexpression.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed ^ static_cast<std::size_t>(subexpression.kind);
+}
+
+Wire* Network::findShared(const Subexpression& subexpression) const
+{
+  if (!mSharingSubexpressions)
+  {
+    return nullptr;
+  }
+  auto found = mShared.find(subexpression);
+  return found != mShared.end() ? found->second : nullptr;
+}
+
+Wire& Network::combine(Wire& a, Value ka, Wire* b, Value kb, Value constant)
+{
+  LinearCombination::Term terms[2];
+  std::size_t count = 0;
+  for (auto& term : {LinearCombination::Term{&a, ka},
+                     LinearCombination::Term{b, kb}})
+  {
+    const Wire* wire = static_cast<const Wire*>(term.wire);
+    if (wire == nullptr)
+    {
+      continue;
+    }
+    if (wire->mConstant)
+    {
+      constant = constant + term.coefficient * wire->mValue;
+    }
+    else
+    {
+      terms[count++] = term;
+    }
+  }
+  if (count == 0)
+  {
+    return this->constant(constant);
+  }
+
+  // Only plain sums of two wires are shared, like additions
+  const bool plainSum = count == 2 && terms[0].coefficient == Value(1)
+                        && terms[1].coefficient == Value(1)
+                        && constant == Value(0);
+  if (plainSum)
+  {
+    if (Wire* shared = findShared(Subexpression('+', a, *b)))
+    {
+      return *shared;
+    }
+  }
+
+  if (!take(1, 1, count, count))
+  {
+    return *mSpareWire;
+  }
+  Wire& sum = createWire(0.0);
+  LinearCombination* combination =
+    create<LinearCombination>(mArena, terms, count, constant, sum);
+  sum.mCombination = combination;
+  addOperation(combination);
+
+  if (plainSum && mSharingSubexpressions)
+  {
+    mShared.emplace(Subexpression('+', a, *b), &sum);
+  }
+  return sum;
+}
+
+void Network::reconnect(Wire& wire)
+{
+  LinearCombination& combination = *wire.mCombination;
+  if (!take(0, 0, combination.countTerms(), combination.countTerms()))
+  {
+    return;
+  }
+  wire.mDetached = false;
+  combination.reconnect();
+  reserveRank(combination.mRank);
+}
+
+Result Network::propagate(Wire& wire)
+{
+  if (mPropagating)
+  {
+    schedule(wire);
+    return Result(true);
+  }
+
+  beginPropagation();
+  CONSTRAINTS_STATS(++mStats.propagations;)
+  schedule(wire);
+  return evaluateScheduled(wire.mRank);
+}
+
+Result Network::probe(const Wire& wire, Value value)
+{
+  assert(!mPropagating);
+  if (mIndexingRelations && wire.mRelations.empty())
+  {
+    // No relation can fail, whatever the value
+    return Result(true);
+  }
+  beginPropagation();
+  CONSTRAINTS_STATS(++mStats.propagations;)
+  mProbing = true;
+  wire.mProbeValue = value;
+  wire.mProbeEpoch = mPropagationEpoch;
+  schedule(wire);
+  Result result = evaluateScheduled(wire.mRank);
+  mProbing = false;
+  return result;
+}
+
+void Network::recordChange(Wire& wire)
+{
+  ++mValueEpoch;
+  if (mRecordingChanges && wire.mSavedTransaction != mTransaction)
+  {
+    wire.mSavedValue = wire.mValue;
+    wire.mSavedTransaction = mTransaction;
+    wire.mNextChanged = mChanged;
+    mChanged = &wire;
+  }
+}
+
+void Network::beginPropagation()
+{
+  mPropagating = true;
+  ++mPropagationEpoch;
+}
+
+void Network::beginQuery() const
+{
+  ++mQuery;
+}
+
+CompiledNetwork
+Network::compile(const std::vector<const Wire*>& wires,
+                 std::vector<const IOperation*>& operations) const
+{
+  CompiledNetwork compiled;
+  for (auto wire : wires)
+  {
+    compiled.addWire(*wire);
+  }
+
+  // Levels grow from the inputs of an operation to its output, so sorting
+  // by level keeps the operations in topological order, and groups them
+  // level by level.
+  std::stable_sort(operations.begin(),
+                   operations.end(),
+                   [](const IOperation* a, const IOperation* b) {
+                     return a->getLevel() < b->getLevel();
+                   });
+  for (auto operation : operations)
+  {
+    operation->compile(compiled);
+  }
+
+  compiled.finish();
+  return compiled;
+}
+
+Range Network::rangeDownstream(const Wire& wire,
+                               const IWire& varyingWire,
+                               bool* solved) const
+{
+  Range range;
+  if (mIndexingRelations)
+  {
+    for (auto relation : wire.mRelations)
+    {
+      if (solved != nullptr && !isSolvable(*relation, varyingWire))
+      {
+        *solved = false;
+        continue;
+      }
+      CONSTRAINTS_TRACE(
+        TraceScope trace(mTrace, TraceEvent::RANGE, relation, nullptr);)
+      range = Range::intersect(range, relation->range(varyingWire));
+    }
+    return range;
+  }
+
+  const unsigned long long walk = ++mRangeWalk;
+  const std::size_t base = mRangeStack.size();
+  wire.mRangeWalk = walk;
+  mRangeStack.push_back(&wire);
+  while (mRangeStack.size() > base)
+  {
+    const Wire& current = *mRangeStack.back();
+    mRangeStack.pop_back();
+    for (auto operation : current.mOperations)
+    {
+      const Wire* output =
+        operation->mOutput != nullptr ? operation->mOutput->asWire() : nullptr;
+      if (output != nullptr)
+      {
+        if (output->mRangeWalk != walk)
+        {
+          output->mRangeWalk = walk;
+          mRangeStack.push_back(output);
+        }
+        continue;
+      }
+      if (solved != nullptr && !isSolvable(*operation, varyingWire))
+      {
+        *solved = false;
+        continue;
+      }
+      CONSTRAINTS_TRACE(
+        TraceScope trace(mTrace, TraceEvent::RANGE, operation, nullptr);)
+      range = Range::intersect(range, operation->range(varyingWire));
+    }
+    CONSTRAINTS_STATS(mStats.maxQueryDepth = std::max(
+                        mStats.maxQueryDepth,
+                        static_cast<unsigned int>(mRangeStack.size() - base
+                                                  + 1));)
+  }
+  return range;
+}
+
+bool Network::isSolvable(const IOperation& relation,
+                         const IWire& varyingWire) const
+{
+  mRelationInputs.clear();
+  relation.appendInputs(mRelationInputs);
+  return std::none_of(
+    mRelationInputs.begin(), mRelationInputs.end(), [&](const IWire* input) {
+      return input->expression(varyingWire).nonlinear;
+    });
+}
+
+void Network::computeExpressions(const Wire& wire,
+                                 const IWire& variable) const
+{
+  const std::size_t base = mExpressionStack.size();
+  mExpressionStack.push_back(PendingWire{&wire, false});
+  while (mExpressionStack.size() > base)
+  {
+    const PendingWire pending = mExpressionStack.back();
+    if (pending.expanded)
+    {
+      mExpressionStack.pop_back();
+      computeExpression(*pending.wire, variable);
+      continue;
+    }
+    if (hasExpression(*pending.wire, variable))
+    {
+      // Reached through another path in the meantime
+      mExpressionStack.pop_back();
+      continue;
+    }
+    mExpressionStack.back().expanded = true;
+    mInputs.clear();
+    pending.wire->mDriver->appendInputs(mInputs);
+    for (auto input : mInputs)
+    {
+      // Other implementations of IWire are asked by the operation directly
+      const Wire* inputWire = input->asWire();
+      if (inputWire == nullptr || input == &variable
+          || inputWire->mDriver == nullptr
+          || hasExpression(*inputWire, variable))
+      {
+        continue;
+      }
+      if (inputWire->mRank == 1)
+      {
+        // Only depends on undriven wires, so it is computed without nesting
+        computeExpression(*inputWire, variable);
+        continue;
+      }
+      mExpressionStack.push_back(PendingWire{inputWire, false});
+    }
+    CONSTRAINTS_STATS(mStats.maxQueryDepth = std::max(
+                        mStats.maxQueryDepth,
+                        static_cast<unsigned int>(mExpressionStack.size()
+                                                  - base));)
+  }
+}
+
+void Network::computeExpression(const Wire& wire,
+                                const IWire& variable) const
+{
+  CONSTRAINTS_TRACE(TraceScope trace(
+    mTrace, TraceEvent::EXPRESSION, wire.mDriver, nullptr);)
+  wire.mExpression = wire.mDriver->expression(variable);
+  wire.mExpressionVariable = &variable;
+  wire.mExpressionValueEpoch = mValueEpoch;
+  wire.mExpressionQuery = mQuery;
+}
+
+void Network::defer(IOperation& operation)
+{
+  CONSTRAINTS_STATS(++mStats.operationsDeferred;)
+  operation.mMissedUpdate = true;
+  const Wire* output =
+    operation.mOutput != nullptr ? operation.mOutput->asWire() : nullptr;
+  if (output == nullptr || output->mDirty)
+  {
+    return;
+  }
+  output->mDirty = true;
+  const std::size_t base = mMarkStack.size();
+  mMarkStack.push_back(output);
+  while (mMarkStack.size() > base)
+  {
+    const Wire& current = *mMarkStack.back();
+    mMarkStack.pop_back();
+    // Nothing downstream of an operation that is not observed is observed
+    for (auto consumer : current.mOperations)
+    {
+      consumer->mMissedUpdate = true;
+      const Wire* next =
+        consumer->mOutput != nullptr ? consumer->mOutput->asWire() : nullptr;
+      if (next != nullptr && !next->mDirty)
+      {
+        next->mDirty = true;
+        mMarkStack.push_back(next);
+      }
+    }
+  }
+}
+
+void Network::refresh(const Wire& wire)
+{
+  // Checks only evaluate observed operations, whose inputs are up to date
+  assert(!mProbing);
+  // Within a propagation, the refreshed outputs only mark their consumers as
+  // outdated again, since none of them is observed
+  const bool propagating = mPropagating;
+  mPropagating = true;
+  const std::size_t base = mRefreshStack.size();
+  mRefreshStack.push_back(PendingWire{&wire, false});
+  while (mRefreshStack.size() > base)
+  {
+    const PendingWire pending = mRefreshStack.back();
+    if (!pending.wire->mDirty)
+    {
+      // Reached through another path in the meantime
+      mRefreshStack.pop_back();
+      continue;
+    }
+    IOperation& driver = *pending.wire->mDriver;
+    if (pending.expanded)
+    {
+      mRefreshStack.pop_back();
+      pending.wire->mDirty = false;
+      CONSTRAINTS_TRACE(
+        TraceScope trace(mTrace, TraceEvent::PROPAGATE, &driver, nullptr);)
+      CONSTRAINTS_STATS(++mStats.operationsEvaluated;)
+      // The missed update makes the driver compute its output from scratch
+      driver.propagateValue();
+      driver.mMissedUpdate = false;
+      continue;
+    }
+    mRefreshStack.back().expanded = true;
+    mRefreshInputs.clear();
+    driver.appendInputs(mRefreshInputs);
+    for (auto input : mRefreshInputs)
+    {
+      const Wire* inputWire = input->asWire();
+      if (inputWire != nullptr && inputWire->mDirty)
+      {
+        mRefreshStack.push_back(PendingWire{inputWire, false});
+      }
+    }
+  }
+  mPropagating = propagating;
+}
+
+void Network::reserveRank(unsigned int rank)
+{
+  if (rank >= mSchedule.size())
+  {
+    mSchedule.resize(rank + 1, ScheduledRank{nullptr, nullptr});
+  }
+}
+
+Result Network::evaluateScheduled(std::size_t lowestRank)
+{
+  // A network with limited capacity keeps the chain of a failure within
+  // what a result stores without allocating
+  const std::size_t maxChainLength = mFixedCapacity
+    ? Result::INLINE_CAPACITY
+    : std::numeric_limits<std::size_t>::max();
+
+  // Operations only schedule operations of strictly higher rank, so each
+  // bucket is complete once all lower buckets have been evaluated.
+  for (std::size_t rank = lowestRank; rank < mScheduledEnd; ++rank)
+  {
+    for (IOperation* operation = mSchedule[rank].first; operation != nullptr;
+         operation = operation->mNextScheduled)
+    {
+      mEvaluating = operation;
+      CONSTRAINTS_TRACE(TraceScope trace(
+                          mTrace, TraceEvent::PROPAGATE, operation, nullptr);)
+      Result result = operation->propagateValue();
+      if (!mProbing)
+      {
+        operation->mMissedUpdate = false;
+      }
+      CONSTRAINTS_STATS(
+        ++mStats.operationsEvaluated;
+        mStats.relationsChecked += operation->mOutput == nullptr;)
+      if (!result)
+      {
+        // The failing operation has added itself
+        std::size_t chainLength = 1;
+        for (const IOperation* cause = operation->mScheduledBy;
+             cause != nullptr && chainLength < maxChainLength;
+             cause = cause->mScheduledBy, ++chainLength)
+        {
+          result.push(cause);
+        }
+        CONSTRAINTS_STATS(++mStats.relationsFailed;
+                          mStats.resultAllocations +=
+                            chainLength > Result::INLINE_CAPACITY;)
+        mSchedule[rank].first = operation->mNextScheduled;
+        finishPropagation(rank);
+        return result;
+      }
+    }
+    mSchedule[rank] = ScheduledRank{nullptr, nullptr};
+  }
+  finishPropagation(mScheduledEnd);
+  return Result(true);
+}
+
+void Network::finishPropagation(std::size_t firstScheduledRank)
+{
+  for (std::size_t rank = firstScheduledRank; rank < mScheduledEnd; ++rank)
+  {
+    // Discarded operations have not seen the change of their inputs
+    for (IOperation* operation = mSchedule[rank].first;
+         operation != nullptr && !mProbing;
+         operation = operation->mNextScheduled)
+    {
+      operation->mMissedUpdate = true;
+    }
+    mSchedule[rank] = ScheduledRank{nullptr, nullptr};
+  }
+  mScheduledEnd = 0;
+  mEvaluating = nullptr;
+  mPropagating = false;
+}
+
+void Network::schedule(const Wire& wire)
+{
+  for (auto operation : wire.mOperations)
+  {
+    if (mLazy && !operation->mObserved)
+    {
+      // A check leaves the values as they are, so nothing becomes outdated
+      if (!mProbing)
+      {
+        defer(*operation);
+      }
+      continue;
+    }
+    if (operation->mScheduledEpoch == mPropagationEpoch)
+    {
+      if (operation->mChangedInput != &wire)
+      {
+        operation->mChangedInput = nullptr;
+      }
+      continue;
+    }
+    operation->mScheduledEpoch = mPropagationEpoch;
+    operation->mChangedInput = &wire;
+    operation->mScheduledBy = mEvaluating;
+    operation->mNextScheduled = nullptr;
+    // Operations created by the factory functions already have a bucket
+    reserveRank(operation->mRank);
+    mScheduledEnd = std::max<std::size_t>(mScheduledEnd, operation->mRank + 1);
+    ScheduledRank& bucket = mSchedule[operation->mRank];
+    if (bucket.last != nullptr)
+    {
+      bucket.last->mNextScheduled = operation;
+    }
+    else
+    {
+      bucket.first = operation;
+    }
+    bucket.last = operation;
+  }
+}
+
 }}
@@ -1,13 +1,32 @@
 // Copyright 2019 SICK AG. All rights reserved.
 
+#pragma once
+
+#include "Arena.h"
+#include "CompiledNetwork.h"
+#include "NetworkStats.h"
+#include "Trace.h"
 #include "Wire.h"
 
-#include <list>
+#include <assert.h>
+#include <functional>
+#include <limits>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace common { namespace constraints {
 
+class Abs;
+class Bounds;
+class Clamp;
+class Equal;
 class IOperation;
 class LessOrEqual;
+class LinearCombination;
+class Max;
+class Min;
 
 /** Holds a forward-propagating constraint network.
 
@@ -41,15 +60,59 @@ class LessOrEqual;
 
       assert(height.set(10));
       assert(width.set(5));
-      double maxHeight = height.range().upper;
+      Value maxHeight = height.range().upper;
     \endcode
 
+    \section propagation Propagation
+    Every wire and operation has a topological rank, which is assigned when the
+    network is built. Undriven wires have rank zero, an operation has the
+    highest rank of its inputs and a driven wire has one more than its driver.
+    When a wire is set, the affected operations are evaluated in rank order,
+    so each operation is evaluated at most once per change, regardless of how
+    many paths lead to it.
+
+    \section constants Constants
+    Literal values used with the wire operators, as in <tt>x * 2 + 5</tt>, are
+    taken from a pool of constant wires so each value is only represented
+    once. Additions and multiplications of constants only are folded when the
+    network is built, so they never take part in propagation or in range
+    queries.
+
+    \section linear Linear combinations
+    The wire operators build sums of wires, and products and sums with
+    literal values, as a \ref LinearCombination. A sum of any length built
+    with \ref linearCombination, or merged by \ref optimize, is propagated
+    as one operation that is updated in constant time when one of its inputs
+    changes.
+
+    \section sharing Subexpression sharing
+    When enabled with \ref setSubexpressionSharing, additions and
+    multiplications of the same two wires share one operation and output
+    wire, in whichever order the operands are given. A subexpression like
+    <tt>a + b</tt> that is used by many relations is then only stored and
+    propagated once.
+
+    \section lazy Lazy evaluation
+    When enabled with \ref setLazyEvaluation, operations whose outputs no
+    relation depends on, e.g., sums that are only displayed, are skipped
+    during propagation. Their outputs are marked as outdated and computed
+    when read, so high-rate updates only pay for what is checked or read.
+
     \section memory Memory management
     The Network owns all the Wires and IOperations that are part of the network.
     Destroying the Network object will invalidate all references to these.
     There is no guarantee that combining wires from different Networks will
     work as intended.
 
+    Wires, operations, names and connection lists are placed in an Arena owned
+    by the network, so building a network makes a few large allocations
+    rather than many small ones, and destroying it releases them at once. The
+    memory can be taken from a caller-supplied MemoryResource.
+
+    Setting a wire does not allocate memory, and takes time proportional to
+    the number of operations, connections and ranks downstream of it. A
+    StaticNetwork additionally places the whole network in a fixed buffer.
+
     \see \ref IWire
     \see \ref IOperation
  */
@@ -71,31 +134,229 @@ public:
    */
   Network(bool verifySoundness);
 
-  /** Creates a wire modeling a double variable. */
-  Wire& make(double value);
-  /** Creates a wire modeling a double variable, with a name for easier
+  /** Creates a network taking its memory from the given resource, which must
+      outlive the network.
+   */
+  Network(bool verifySoundness, MemoryResource& memory);
+
+  ~Network();
+
+  /** Creates a wire modeling a variable. */
+  Wire& make(Value value);
+  /** Creates a wire modeling a variable, with a name for easier
       debugging.
    */
-  Wire& make(std::string name, double value);
+  Wire& make(std::string name, Value value);
+  Wire& make(const char* name, Value value);
+  /** Gets the constant wire with the given value. Constants are shared, so
+      every use of the same literal value refers to the same wire, and
+      setting them to another value fails.
+   */
+  Wire& constant(Value value);
 
-  /** Creates an addition operation between two wires.
-      \return the output wire for the sum
+  /** Creates an addition operation between two wires. If both wires are
+      constants, no operation is created.
+      \return the output wire for the sum, or the constant holding it
       \note Prefer using the \ref Wire::operator+()
    */
   Wire& add(Wire& termA, Wire& termB);
 
-  /** Creates a multiplication operation between two wires.
-      \return the output wire for the product
+  /** Creates a multiplication operation between two wires. If both wires are
+      constants, no operation is created.
+      \return the output wire for the product, or the constant holding it
       \note Prefer using the \ref Wire::operator*()
    */
   Wire& multiply(Wire& factorA, Wire& factorB);
 
+  /** Creates a weighted sum of wires. Constant wires are folded into the
+      constant, and repeated wires into one input. If all wires are
+      constants, no operation is created.
+      \return the output wire for the sum, or the constant holding it
+      \note The wire operators build linear combinations automatically
+   */
+  Wire& linearCombination(const std::vector<std::pair<Wire*, Value>>& terms,
+                          Value constant = 0);
+
+  /** Creates an operation giving the smaller of two wires. If both wires
+      are constants, no operation is created.
+      \return the output wire for the minimum, or the constant holding it
+      \note Prefer using the \ref min()
+   */
+  Wire& minimum(Wire& inputA, Wire& inputB);
+
+  /** Creates an operation giving the larger of two wires. If both wires are
+      constants, no operation is created.
+      \return the output wire for the maximum, or the constant holding it
+      \note Prefer using the \ref max()
+   */
+  Wire& maximum(Wire& inputA, Wire& inputB);
+
+  /** Creates an operation giving the absolute value of a wire. If the wire
+      is a constant, no operation is created.
+      \return the output wire for the absolute value, or the constant
+      holding it
+      \note Prefer using the \ref abs()
+   */
+  Wire& absolute(Wire& input);
+
+  /** Creates an operation limiting a wire to lower <= wire <= upper. If the
+      wire is a constant, no operation is created.
+      \return the output wire for the clamped value, or the constant holding
+      it
+      \note Prefer using the \ref clamp()
+   */
+  Wire& clamp(Wire& input, Value lower, Value upper);
+
   /** Creates an less-than-or-equal-to relation operation between two wires.
       \return the actual operation object
       \note Prefer using the \ref Wire::operator<=()
   */
   LessOrEqual& lessOrEqual(IWire& left, IWire& right);
 
+  /** Creates a window relation lower <= wire <= upper. Prefer it over two
+      less-than-or-equal-to relations, since it is checked and solved as one
+      operation.
+      \return the actual operation object
+      \note Prefer using the \ref Wire::within()
+   */
+  Bounds& bounds(IWire& wire, Value lower, Value upper);
+
+  /** Creates an equality relation between two wires, which holds if they
+      differ by at most the given tolerance.
+      \return the actual operation object
+      \note Prefer using the \ref Wire::equals()
+   */
+  Equal& equal(IWire& left, IWire& right, Value tolerance = 0);
+
+  /** Assigns values to several wires as one transaction. All values are
+      applied before propagation, so operations affected by more than one of
+      the wires are only evaluated once. If any constraint fails, every wire
+      touched by the transaction is restored to the value it had before.
+      Changing a constant wire fails without touching any wire.
+      \return a result object to know if the values were allowed
+   */
+  Result setMany(const std::vector<std::pair<Wire*, Value>>& values);
+
+  /** Assigns the given number of values from an array as one transaction,
+      the same way as the overload taking a vector, but without requiring
+      the values to be on the heap.
+      \return a result object to know if the values were allowed
+   */
+  Result setMany(const std::pair<Wire*, Value>* values, std::size_t count);
+
+  /** Freezes the current topology and values of the network into flat
+      arrays. The compiled network evaluates faster, but operations added to
+      this network afterwards are not part of it.
+   */
+  CompiledNetwork compile() const;
+
+  /** Computes the allowed range of every wire in the network, giving the
+      same ranges as calling Wire::range() on each of them, up to rounding.
+
+      Instead of deriving an expression per wire and relation, the ranges are
+      found with one reverse sweep over the network, which carries the
+      coefficients of the relations downstream of each wire up to its inputs.
+      Relations that are only reached through one wire are folded into a
+      single window on that wire, so a chain of constrained wires is swept in
+      linear time. Only for wires upstream of a piecewise operation, or of
+      both factors of a multiplication, are expressions derived the usual
+      way. Unlike Wire::range(), a wire that a relation depends on
+      nonlinearly does not fail the computation; it is left out of the map.
+   */
+  std::unordered_map<const Wire*, Range> computeAllRanges() const;
+
+  /** Gets the number of bytes of memory reserved for wires, operations and
+      their connections.
+   */
+  std::size_t getReservedBytes() const;
+  /** Gets the number of bytes of the reserved memory taken so far. */
+  std::size_t getUsedBytes() const;
+
+  /** Enables keeping the expressions computed by range queries until a wire
+      value changes, instead of discarding them after each query. This speeds
+      up repeated range queries on a network whose values rarely change.
+   */
+  void setExpressionCaching(bool enabled);
+
+  /** Enables lazy evaluation, in which operations that no relation depends
+      on are not evaluated during propagation. Setting a wire then only marks
+      the wires downstream of such operations as outdated, and reading one of
+      them evaluates the deferred operations it depends on. Relations and the
+      operations they depend on are evaluated as before. Disabled by default;
+      disabling it brings every outdated wire up to date.
+   */
+  void setLazyEvaluation(bool enabled);
+
+  /** Marks a wire as read by the application. The operations it depends on
+      are then treated like those a relation depends on: they are evaluated
+      during propagation with lazy evaluation, and kept by \ref optimize.
+   */
+  void pin(Wire& wire);
+
+  /** Simplifies a built network, so that setting wires does less work.
+
+      Operations that neither a relation nor a pinned wire depends on are
+      removed, and their output wires become variables that keep their
+      current values. A linear combination whose output is only used by
+      another linear combination, and is not pinned, is merged into that
+      one, and its output is computed when read.
+      Finally, the schedule is trimmed to the ranks that are still in use.
+
+      Wires stay valid and keep their names. The memory of the removed
+      operations stays reserved until the network is destroyed.
+   */
+  void optimize();
+
+  /** Builds an index from every wire to the relations downstream of it,
+      which is kept up to date as relations are added afterwards. Range
+      queries then ask the relations of a wire directly instead of walking
+      the network downstream, and checking a value for a wire that no
+      relation depends on succeeds without propagating it.
+
+      Each relation added updates the index of every wire upstream of it, so
+      build the index once the network is mostly complete. The index takes
+      memory for every pair of a wire and a relation downstream of it, so
+      networks with a capacity, like StaticNetwork, cannot build it.
+   */
+  void indexRelations();
+
+  /** Gets the relations downstream of a wire, i.e., the constraints that
+      setting it can violate, in the order they were created. Requires
+      \ref indexRelations.
+   */
+  const IOperation::Relations& getRelations(const Wire& wire) const;
+
+  /** Enables reusing an existing addition or multiplication of the same two
+      wires instead of creating a new one. Only operations created while
+      enabled are shared. Disabled by default.
+   */
+  void setSubexpressionSharing(bool enabled);
+
+  /** Checks whether the network has refused to create a wire or operation
+      because its capacity was exhausted. Only networks with a capacity, like
+      StaticNetwork, can be exhausted.
+
+      Once exhausted, the factory functions return placeholder objects that
+      are not connected to the rest of the network, so the network should be
+      considered unusable.
+   */
+  bool isCapacityExhausted() const;
+
+  /** Gets a snapshot of the work counters of the network. The counters are
+      only updated if the library is built with CONSTRAINTS_ENABLE_STATS.
+      \see \ref NetworkStats
+   */
+  NetworkStats stats() const;
+  /** Sets all work counters to zero. */
+  void resetStats();
+
+  /** Starts recording the time spent in each operation while propagating
+      and querying ranges, or stops if given null. Recording only takes place
+      if the library is built with CONSTRAINTS_ENABLE_TRACING.
+      \see \ref TraceBuffer
+   */
+  void setTraceBuffer(TraceBuffer* buffer);
+
   bool isVerifyingSoundness();
 
   /** Activates immediate verification that new constraints are sound when they
@@ -107,14 +368,365 @@ public:
    */
   bool activateSoundnessVerification();
 
+protected:
+  /** Limits on the size of a network. */
+  struct Capacity
+  {
+    std::size_t wires;
+    std::size_t operations;
+    /** Number of operation inputs. */
+    std::size_t connections;
+    /** Bytes for wire names, including terminators. */
+    std::size_t nameBytes;
+  };
+
+  /** Creates a network with limited capacity in the given buffer. Memory for
+      the given capacity is reserved up front and the network never allocates
+      outside the buffer. A factory function only creates something if the
+      buffer has room for the most it can take, so running out of buffer
+      exhausts the network like running out of capacity. If the buffer
+      cannot hold the up-front reservations, the network starts exhausted.
+   */
+  Network(bool verifySoundness,
+          void* buffer,
+          std::size_t bytes,
+          const Capacity& capacity);
+
 private:
   Network(const Network&) = delete;
   void operator=(const Network&) = delete;
 
+  /** Checks that the network has room for more wires, operations and
+      connections, and takes it. Marks the network as exhausted otherwise.
+      A network with a fixed capacity also checks that its buffer has room
+      for the objects, and for the growth of the connection lists and of a
+      linear combination with the given number of terms.
+   */
+  bool take(std::size_t wires,
+            std::size_t operations,
+            std::size_t connections,
+            std::size_t terms = 0);
+  /** Checks whether a network with a fixed capacity has the given number of
+      bytes left in its buffer. Always true for other networks.
+   */
+  bool fits(std::size_t bytes) const;
+
+  /** Constructs an object in the arena. */
+  template <class T, class... Arguments>
+  T* create(Arguments&&... arguments);
+  /** Takes ownership of a new operation. */
+  void addOperation(IOperation* operation);
+  /** Marks an operation and every operation upstream of it as observed.
+      Outdated wires are brought up to date before their drivers become
+      observed.
+   */
+  void observe(IOperation& operation);
+  /** Checks whether \ref optimize may remove an operation. Disconnected
+      linear combinations are kept, since they define the values of
+      intermediate wires.
+   */
+  bool isRemovable(const IOperation& operation) const;
+  /** Checks whether \ref optimize may merge the linear combination driving
+      a wire into the one consumer of the wire.
+   */
+  bool isMergeable(const Wire& wire) const;
+  /** Adds a relation to the index of every wire upstream of it. */
+  void indexRelation(const IOperation& relation);
+  /** Creates an undriven wire without a name. */
+  Wire& createWire(Value value);
+  /** Copies a name into the arena.
+      \return the copy, or null if the name capacity is exhausted
+   */
+  const char* copyName(const char* name, std::size_t length);
+
+  /** Identifies an addition or multiplication by its operands, ordered so
+      that commuted operations compare equal.
+   */
+  struct Subexpression
+  {
+    Subexpression(char kind, const Wire& operandA, const Wire& operandB);
+    bool operator==(const Subexpression& other) const;
+
+    char kind;
+    const Wire* first;
+    const Wire* second;
+  };
+
+  struct SubexpressionHash
+  {
+    std::size_t operator()(const Subexpression& subexpression) const;
+  };
+
+  /** Gets the output of a shared operation with the given operands, or null
+      if there is none.
+   */
+  Wire* findShared(const Subexpression& subexpression) const;
+
+  /** Builds ka * a + kb * b + constant for the wire operators, where b may be
+      null, as a new linear combination reading a and b.
+   */
+  Wire& combine(Wire& a, Value ka, Wire* b, Value kb, Value constant);
+  /** Connects the linear combination driving a disconnected wire, which is
+      about to be used as an input.
+   */
+  void reconnect(Wire& wire);
+
+  /** Evaluates all operations downstream of a wire whose value has changed.
+      If called while a propagation is already running, the operations
+      connected to the wire are scheduled as part of that propagation instead.
+   */
+  Result propagate(Wire& wire);
+  /** Propagates a candidate value for a wire using the scratch values of the
+      wires, leaving their actual values untouched.
+   */
+  Result probe(const Wire& wire, Value value);
+  /** Notes that the value of a wire is about to change, which invalidates
+      memoized expressions. Also records the current value of the wire if a
+      transaction is in progress.
+   */
+  void recordChange(Wire& wire);
+  void beginPropagation();
+  /** Starts a range query, within which expressions are memoized. */
+  void beginQuery() const;
+  /** Checks whether an expression memoized at the given value epoch and query
+      may be reused.
+   */
+  bool isExpressionValid(unsigned long long valueEpoch,
+                         unsigned long long query) const;
+  /** Checks whether the memoized expression of a wire is one of the given
+      variable that may still be used.
+   */
+  bool hasExpression(const Wire& wire, const IWire& variable) const;
+  /** Computes and memoizes the expression of a driven wire. The expressions
+      of the inputs of its driver should be memoized already.
+   */
+  void computeExpression(const Wire& wire, const IWire& variable) const;
+  /** Intersects the ranges of varyingWire given by the relations downstream
+      of a wire. Walks through the operations with an output on a work stack
+      instead of recursing, and reaches every relation once. If solved is
+      given, it is cleared instead of failing when a relation depends
+      nonlinearly on varyingWire.
+   */
+  Range rangeDownstream(const Wire& wire,
+                        const IWire& varyingWire,
+                        bool* solved = nullptr) const;
+  /** Checks whether the range of varyingWire given by a relation can be
+      solved, i.e., whether the relation depends linearly on it.
+   */
+  bool isSolvable(const IOperation& relation,
+                  const IWire& varyingWire) const;
+  /** Compiles the given operations and wires, which must include every wire
+      the operations connect to.
+   */
+  CompiledNetwork compile(const std::vector<const Wire*>& wires,
+                          std::vector<const IOperation*>& operations) const;
+  /** Compiles the operations downstream of a wire, together with all the
+      wires they connect to, leaving out the rest of the network.
+   */
+  CompiledNetwork compileDownstream(const Wire& root) const;
+  /** Computes the range of the wanted wires of a compiled snapshot of this
+      network in one reverse sweep, by wire index. See \ref computeAllRanges.
+      In a snapshot of part of the network, only the wires whose relations
+      are all part of it get their full range. A wanted wire that a relation
+      depends on nonlinearly is marked as not solved, and gets the full
+      range.
+   */
+  std::vector<Range> computeRanges(const CompiledNetwork& tape,
+                                   const std::vector<bool>& wanted,
+                                   std::vector<bool>& solved) const;
+  /** Memoizes the expression of a driven wire as a function of variable,
+      together with those of the wires upstream of it that are needed. The
+      wires are visited on a work stack, and each expression is computed
+      after those of the inputs of its driver, so no call recurses further
+      than one operation.
+   */
+  void computeExpressions(const Wire& wire, const IWire& variable) const;
+  /** Skips an operation that is not observed, marking its output and the
+      wires downstream of it as outdated.
+   */
+  void defer(IOperation& operation);
+  /** Brings an outdated wire up to date by evaluating the deferred
+      operations it depends on, inputs first, on a work stack.
+   */
+  void refresh(const Wire& wire);
+  /** Makes room in the schedule for operations of the given rank. */
+  void reserveRank(unsigned int rank);
+  /** Evaluates the scheduled operations in rank order, starting at the given
+      rank, and ends the propagation.
+   */
+  Result evaluateScheduled(std::size_t lowestRank);
+  /** Schedules the operations connected to a wire for evaluation in the
+      current propagation.
+   */
+  void schedule(const Wire& wire);
+  /** Ends the current propagation, discarding operations that are still
+      scheduled from the given rank and up.
+   */
+  void finishPropagation(std::size_t firstScheduledRank);
+
 private:
-  std::list<std::unique_ptr<Wire>> mWires;
-  std::list<std::unique_ptr<IOperation>> mOperations;
+  Arena mArena;
+  std::vector<Wire*, ArenaAllocator<Wire*>> mWires{
+    ArenaAllocator<Wire*>(mArena)};
+  std::vector<IOperation*, ArenaAllocator<IOperation*>> mOperations{
+    ArenaAllocator<IOperation*>(mArena)};
+  /** Constant wires by value, keyed as double so every value type can be
+      hashed.
+   */
+  std::unordered_map<double,
+                     Wire*,
+                     std::hash<double>,
+                     std::equal_to<double>,
+                     ArenaAllocator<std::pair<const double, Wire*>>>
+    mConstants{0,
+               std::hash<double>(),
+               std::equal_to<double>(),
+               ArenaAllocator<std::pair<const double, Wire*>>(mArena)};
+  /** Outputs of the operations created while sharing was enabled. */
+  std::unordered_map<Subexpression,
+                     Wire*,
+                     SubexpressionHash,
+                     std::equal_to<Subexpression>,
+                     ArenaAllocator<std::pair<const Subexpression, Wire*>>>
+    mShared{0,
+            SubexpressionHash(),
+            std::equal_to<Subexpression>(),
+            ArenaAllocator<std::pair<const Subexpression, Wire*>>(mArena)};
+  bool mSharingSubexpressions = false;
+
+  /** Limits set by the constructor, and the amount used of each. */
+  Capacity mCapacity{std::numeric_limits<std::size_t>::max(),
+                     std::numeric_limits<std::size_t>::max(),
+                     std::numeric_limits<std::size_t>::max(),
+                     std::numeric_limits<std::size_t>::max()};
+  Capacity mUsed{0, 0, 0, 0};
+  /** Whether the network was created with a capacity in a fixed buffer. */
+  bool mFixedCapacity = false;
+  bool mExhausted = false;
+  /** Most operations connected to any wire, which bounds how much memory
+      the next connection list to grow takes.
+   */
+  std::size_t mLongestConnectionList = 0;
+  /** Returned by the factory functions when the capacity is exhausted. */
+  Wire* mSpareWire = nullptr;
+  LessOrEqual* mSpareRelation = nullptr;
+  Bounds* mSpareBounds = nullptr;
+  Equal* mSpareEqual = nullptr;
 
   bool mVerifySoundness = true;
+
+  /** Operations scheduled for evaluation in one rank, linked through
+      IOperation::mNextScheduled in the order they were scheduled.
+   */
+  struct ScheduledRank
+  {
+    IOperation* first;
+    IOperation* last;
+  };
+
+  /** Operations scheduled for evaluation, bucketed by rank. There is a bucket
+      for every rank in the network, so scheduling never allocates.
+   */
+  std::vector<ScheduledRank, ArenaAllocator<ScheduledRank>> mSchedule{
+    ArenaAllocator<ScheduledRank>(mArena)};
+  /** One more than the highest rank scheduled in the current propagation,
+      so that buckets reserved beyond it are not scanned.
+   */
+  std::size_t mScheduledEnd = 0;
+  unsigned long long mPropagationEpoch = 0;
+  bool mPropagating = false;
+  /** Whether the current propagation writes scratch values. */
+  bool mProbing = false;
+  /** The operation currently being evaluated, or null. */
+  const IOperation* mEvaluating = nullptr;
+
+  /** Work counters, kept regardless of CONSTRAINTS_ENABLE_STATS so that the
+      layout of the network does not depend on it.
+   */
+  mutable NetworkStats mStats = NetworkStats();
+  /** Receives trace events, or null. Kept regardless of
+      CONSTRAINTS_ENABLE_TRACING like the counters.
+   */
+  TraceBuffer* mTrace = nullptr;
+
+  /** Incremented whenever any wire value changes. */
+  unsigned long long mValueEpoch = 0;
+  /** Incremented for every range query. */
+  mutable unsigned long long mQuery = 0;
+  bool mCachingExpressions = false;
+
+  /** A wire on the work stack of an upstream walk, which is expanded into
+      the inputs of its driver before the wire itself is visited.
+   */
+  struct PendingWire
+  {
+    const Wire* wire;
+    bool expanded;
+  };
+
+  /** Work stacks of range and expression queries, kept so that queries do
+      not allocate once they have grown. Nested queries use the part of a
+      stack above the entries of the outer query.
+   */
+  mutable std::vector<const Wire*, ArenaAllocator<const Wire*>> mRangeStack{
+    ArenaAllocator<const Wire*>(mArena)};
+  mutable std::vector<PendingWire, ArenaAllocator<PendingWire>>
+    mExpressionStack{ArenaAllocator<PendingWire>(mArena)};
+  /** Scratch list for the inputs of one operation. */
+  mutable IOperation::Inputs mInputs{ArenaAllocator<IWire*>(mArena)};
+  /** Scratch list for the inputs of a relation, see \ref isSolvable. */
+  mutable IOperation::Inputs mRelationInputs{ArenaAllocator<IWire*>(mArena)};
+  /** Incremented for every walk of \ref rangeDownstream. */
+  mutable unsigned long long mRangeWalk = 0;
+
+  bool mLazy = false;
+  /** Work stacks of lazy evaluation, for marking wires as outdated or
+      observed, and for bringing them up to date.
+   */
+  std::vector<const Wire*, ArenaAllocator<const Wire*>> mMarkStack{
+    ArenaAllocator<const Wire*>(mArena)};
+  std::vector<PendingWire, ArenaAllocator<PendingWire>> mRefreshStack{
+    ArenaAllocator<PendingWire>(mArena)};
+  IOperation::Inputs mRefreshInputs{ArenaAllocator<IWire*>(mArena)};
+
+  /** Whether every wire knows the relations downstream of it. */
+  bool mIndexingRelations = false;
+
+  /** Wires changed in the current transaction, linked through
+      Wire::mNextChanged. Each wire keeps its value from before the
+      transaction.
+   */
+  Wire* mChanged = nullptr;
+  unsigned long long mTransaction = 0;
+  bool mRecordingChanges = false;
+
+  // Allow wires to propagate and allocate
+  friend class Wire;
+  // Allow linear combinations to tell checks from propagations
+  friend class LinearCombination;
+  // Allow exporters to compute the ranges of their snapshot
+  friend class Exporter;
 };
+
+template <class T, class... Arguments>
+T* Network::create(Arguments&&... arguments)
+{
+  void* memory = mArena.allocate(sizeof(T), alignof(T));
+  assert(memory != nullptr);
+  return new (memory) T(std::forward<Arguments>(arguments)...);
+}
+
+inline bool Network::isExpressionValid(unsigned long long valueEpoch,
+                                       unsigned long long query) const
+{
+  return valueEpoch == mValueEpoch && (mCachingExpressions || query == mQuery);
+}
+
+inline bool Network::hasExpression(const Wire& wire,
+                                   const IWire& variable) const
+{
+  return wire.mExpressionVariable == &variable
+         && isExpressionValid(wire.mExpressionValueEpoch,
+                              wire.mExpressionQuery);
+}
 }}
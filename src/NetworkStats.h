@@ -0,0 +1,54 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+/** Expands to its arguments only when the statistics are enabled, so that
+    counting compiles to nothing otherwise.
+ */
+#if defined(CONSTRAINTS_ENABLE_STATS)
+#define CONSTRAINTS_STATS(...) __VA_ARGS__
+#else
+#define CONSTRAINTS_STATS(...)
+#endif
+
+namespace common { namespace constraints {
+
+/** Counters of the work done by a Network, to find out why setting a value
+    or querying a range is slow.
+
+    The counters are only updated if the library is built with
+    CONSTRAINTS_ENABLE_STATS defined, and are all zero otherwise.
+
+    \see \ref Network::stats
+ */
+struct NetworkStats
+{
+  /** Number of propagations started by setting or checking wire values. */
+  unsigned long long propagations;
+  /** Number of operations evaluated during propagation. */
+  unsigned long long operationsEvaluated;
+  /** Number of wire values written, including scratch values of checks. */
+  unsigned long long wiresWritten;
+  /** Number of operations that lazy evaluation deferred instead of
+      evaluating during propagation, not counting those downstream of them.
+   */
+  unsigned long long operationsDeferred;
+  /** Number of relations evaluated during propagation. */
+  unsigned long long relationsChecked;
+  /** Number of relations that did not hold. */
+  unsigned long long relationsFailed;
+  /** Number of failed results whose chain of operations was too long to be
+      stored without allocating.
+   */
+  unsigned long long resultAllocations;
+  /** Number of range queries on wires. */
+  unsigned long long rangeQueries;
+  /** Number of calls to Wire::expression, made by range queries. */
+  unsigned long long expressionCalls;
+  /** Most wires on the work stack of a range or expression query, counting
+      the one being visited. Queries do not recurse, so this is the depth
+      they reach without using native stack.
+   */
+  unsigned int maxQueryDepth;
+};
+
+}}
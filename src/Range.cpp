@@ -7,9 +7,13 @@
 
 namespace common { namespace constraints {
 
-const double Range::POSITIVE_INFINITY = std::numeric_limits<double>::infinity();
-const double Range::NEGATIVE_INFINITY =
-  -std::numeric_limits<double>::infinity();
+// Types without infinity use their largest and lowest values instead
+const Value Range::POSITIVE_INFINITY = std::numeric_limits<Value>::has_infinity
+  ? std::numeric_limits<Value>::infinity()
+  : std::numeric_limits<Value>::max();
+const Value Range::NEGATIVE_INFINITY = std::numeric_limits<Value>::has_infinity
+  ? -std::numeric_limits<Value>::infinity()
+  : std::numeric_limits<Value>::lowest();
 const Range Range::FULL = Range();
 const Range Range::EMPTY = Range(1, 0);
 
@@ -19,7 +23,7 @@ Range::Range()
 {
 }
 
-Range::Range(double lower, double upper)
+Range::Range(Value lower, Value upper)
   : lower(lower)
   , upper(upper)
 {
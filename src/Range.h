@@ -1,6 +1,8 @@
 // Copyright 2019 SICK AG. All rights reserved.
 #pragma once
 
+#include "Value.h"
+
 #include <limits>
 
 // Forward-declares std::ostream
@@ -13,9 +15,9 @@ struct Range
 {
 public:
   /** Helper constant for infinity to avoid std::numeric_limits. */
-  static const double POSITIVE_INFINITY;
+  static const Value POSITIVE_INFINITY;
   /** Helper constant for infinity to avoid std::numeric_limits. */
-  static const double NEGATIVE_INFINITY;
+  static const Value NEGATIVE_INFINITY;
   /** The range of the full number line; from -infinity to +infinity */
   static const Range FULL;
   /** The empty range, containing no values */
@@ -23,7 +25,7 @@ public:
 
   /** Creates a range from -infinity to +infinity. */
   Range();
-  Range(double lower, double upper);
+  Range(Value lower, Value upper);
   Range(const Range& other) = default;
   Range(Range&& other) = default;
 
@@ -41,9 +43,9 @@ public:
 
 public:
   /** The lowest value in the set, inclusive. */
-  double lower;
+  Value lower;
   /** The highest value in the set, inclusive. */
-  double upper;
+  Value upper;
 };
 
 /** Helper function for stringifying a Range */
@@ -3,13 +3,19 @@
 #include "Result.h"
 
 #include "IOperation.h"
+#include "IWire.h"
 
 #include <sstream>
 
 namespace common { namespace constraints {
 
+const std::size_t Result::INLINE_CAPACITY;
+
 Result::Result(bool success)
   : mSuccess(success)
+  , mLength(0)
+  , mConstant(nullptr)
+  , mInline()
 {
 }
 
@@ -20,18 +26,46 @@ Result::operator bool() const
 
 void Result::push(const IOperation* operation)
 {
-  mOperations.push_front(operation);
+  // Stored in push order; the chain is read back to front
+  if (mLength < INLINE_CAPACITY)
+  {
+    mInline[mLength] = operation;
+  }
+  else
+  {
+    mOverflow.push_back(operation);
+  }
+  ++mLength;
+}
+
+void Result::rejectConstant(const IWire* constant)
+{
+  mConstant = constant;
 }
 
 std::string Result::getErrorMessage() const
 {
   std::ostringstream message;
-  for (auto operation : mOperations)
+  if (mConstant != nullptr)
+  {
+    message << "Constant " << mConstant->getName()
+            << " cannot change, since every use of its value shares it";
+  }
+  for (std::size_t i = mLength; i > 0; --i)
   {
-    message << operation->getErrorMessage();
+    message << pushed(i - 1)->getErrorMessage();
   }
   message << ".";
   return message.str();
 }
 
+// ----------------------------------------------------------------------------
+// Private members
+
+const IOperation* Result::pushed(std::size_t index) const
+{
+  return index < INLINE_CAPACITY ? mInline[index]
+                                 : mOverflow[index - INLINE_CAPACITY];
+}
+
 }}
@@ -1,26 +1,42 @@
 // Copyright 2019 SICK AG. All rights reserved.
 #pragma once
 
-#include <list>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace common { namespace constraints {
 
 class IOperation;
+class IWire;
 
-/** Holds information about the outcome of setting the value of a Wire. */
+/** Holds information about the outcome of setting the value of a Wire.
+
+    A successful result holds nothing but its success value. A failed result
+    records the chain of operations that led to the failing relation, the
+    first few of them inline and the rest in an overflow buffer. A result
+    that failed because a constant was asked to change records the constant
+    instead. The error message is only put together when it is asked for.
+ */
 class Result
 {
 public:
+  /** Number of operations in the chain that are stored without allocating. */
+  static const std::size_t INLINE_CAPACITY = 8;
+
   /** Creates a result with a success value
       \param success true if the setting was successful
    */
   Result(bool success);
   Result(Result&& result) = default;
   Result(const Result& result) = default;
+  Result& operator=(Result&& result) = default;
+  Result& operator=(const Result& result) = default;
 
-  /** Adds to the chain of operations that are affected */
+  /** Adds to the front of the chain of operations that are affected */
   void push(const IOperation* operation);
+  /** Records that the setting failed because it would change a constant */
+  void rejectConstant(const IWire* constant);
   /** Returns a message detailing why the setting was not successful in terms of
       which operations are affected
    */
@@ -29,9 +45,16 @@ public:
   /** Returns the success value of this result */
   operator bool() const;
 
+private:
+  /** Gets an operation by the order it was pushed in. */
+  const IOperation* pushed(std::size_t index) const;
+
 private:
   bool mSuccess;
-  std::list<const IOperation*> mOperations;
+  std::size_t mLength;
+  const IWire* mConstant;
+  const IOperation* mInline[INLINE_CAPACITY];
+  std::vector<const IOperation*> mOverflow;
 };
 
 }}
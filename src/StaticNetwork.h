@@ -0,0 +1,93 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "Bounds.h"
+#include "Equal.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <cstddef>
+
+namespace common { namespace constraints {
+
+/** Holds the buffer of a StaticNetwork. A base class, so that it is
+    constructed before the network.
+ */
+template <std::size_t Bytes>
+class StaticNetworkStorage
+{
+protected:
+  alignas(std::max_align_t) unsigned char mBuffer[Bytes];
+};
+
+/** A constraint network with a fixed capacity, which never allocates memory
+    from the heap.
+
+    All wires, operations, names and bookkeeping are placed in a buffer that
+    is part of the object. The network is built and used the same way as a
+    Network.
+
+    \tparam MaxWires number of wires, including those created for literal
+            values, once per distinct value
+    \tparam MaxOperations number of operations and relations
+    \tparam MaxConnections number of operation inputs, counting each term of
+            a linear combination
+    \tparam BufferBytes size of the buffer. How much of it a network takes
+            depends on the standard library, so build the network once on
+            the target with a large buffer and read
+            \ref Network::getUsedBytes. Since a factory function only
+            creates something if the buffer has room for the most it can
+            take, leave room for the largest step on top of that.
+    \tparam MaxNameBytes number of bytes of wire names, including their
+            terminators
+
+    Creating more than the capacity, or more than fits in the buffer, does
+    not allocate. Instead the network is marked as exhausted and the factory
+    functions return placeholders, so the outcome is the same every time the
+    same network is built. Check \ref isCapacityExhausted after building.
+
+    Setting a wire takes time bounded by the operations and ranks that are
+    scheduled, independent of the capacity. To avoid allocating, the chain
+    of operations in a failed result is limited to the
+    Result::INLINE_CAPACITY operations closest to the failing relation.
+
+    Example code with a static network:
+    \code{.cpp}
+      StaticNetwork<16, 16, 32, 16384> network;
+      Wire& height = network.make("Height", 0);
+      height * 2 + 5 <= 100;
+      assert(!network.isCapacityExhausted());
+      assert(height.set(10));
+    \endcode
+ */
+template <std::size_t MaxWires,
+          std::size_t MaxOperations,
+          std::size_t MaxConnections,
+          std::size_t BufferBytes,
+          std::size_t MaxNameBytes = 16 * MaxWires>
+class StaticNetwork
+  : private StaticNetworkStorage<BufferBytes>
+  , public Network
+{
+  static_assert(BufferBytes >= sizeof(Wire) + sizeof(LessOrEqual)
+                                 + sizeof(Bounds) + sizeof(Equal)
+                                 + 12 * sizeof(void*)
+                                 + 6 * alignof(std::max_align_t),
+                "The buffer must hold at least the placeholder objects");
+
+public:
+  /** Creates a static network, specifying whether to assert when a constraint
+      that does not hold is added.
+   */
+  explicit StaticNetwork(bool verifySoundness = true)
+    : Network(verifySoundness,
+              this->mBuffer,
+              sizeof(this->mBuffer),
+              Capacity{MaxWires, MaxOperations, MaxConnections, MaxNameBytes})
+  {
+  }
+};
+
+}}
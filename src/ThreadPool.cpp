@@ -0,0 +1,129 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace common { namespace constraints {
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+  : mShares(new Share[std::max(threadCount, 1u)])
+  , mThreadCount(std::max(threadCount, 1u))
+{
+  for (unsigned int thread = 1; thread < mThreadCount; ++thread)
+  {
+    mThreads.emplace_back(&ThreadPool::workerLoop, this, thread);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mStart.notify_all();
+  for (auto& thread : mThreads)
+  {
+    thread.join();
+  }
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+  return mThreadCount;
+}
+
+void ThreadPool::parallelFor(
+  std::size_t count,
+  std::size_t chunkSize,
+  const std::function<void(std::size_t, std::size_t)>& body)
+{
+  assert(chunkSize > 0);
+  const std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+  if (mThreadCount == 1 || chunks <= 1)
+  {
+    if (count > 0)
+    {
+      body(0, count);
+    }
+    return;
+  }
+
+  // Deal out the chunks in equal contiguous shares
+  for (unsigned int thread = 0; thread < mThreadCount; ++thread)
+  {
+    mShares[thread].next.store(chunks * thread / mThreadCount,
+                               std::memory_order_relaxed);
+    mShares[thread].end = chunks * (thread + 1) / mThreadCount;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBody = &body;
+    mCount = count;
+    mChunkSize = chunkSize;
+    mBusy = mThreadCount - 1;
+    ++mGeneration;
+  }
+  mStart.notify_all();
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDone.wait(lock, [this] { return mBusy == 0; });
+  mBody = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Private members
+
+void ThreadPool::work(unsigned int thread)
+{
+  // Own share first, then steal from the others in turn. Owner and thieves
+  // both claim chunks with fetch_add, so each chunk is run exactly once.
+  for (unsigned int i = 0; i < mThreadCount; ++i)
+  {
+    Share& share = mShares[(thread + i) % mThreadCount];
+    for (;;)
+    {
+      const std::size_t chunk =
+        share.next.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= share.end)
+      {
+        break;
+      }
+      const std::size_t begin = chunk * mChunkSize;
+      (*mBody)(begin, std::min(begin + mChunkSize, mCount));
+    }
+  }
+}
+
+void ThreadPool::workerLoop(unsigned int thread)
+{
+  unsigned long long generation = 0;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mStart.wait(lock,
+                  [&] { return mStopping || mGeneration != generation; });
+      if (mStopping)
+      {
+        return;
+      }
+      generation = mGeneration;
+    }
+
+    work(thread);
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      --mBusy;
+    }
+    mDone.notify_one();
+  }
+}
+
+}}
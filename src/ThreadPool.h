@@ -0,0 +1,74 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace common { namespace constraints {
+
+/** A fixed set of worker threads for running parallel loops.
+
+    The iterations of a loop are split into chunks, and each thread starts
+    with an equal share of them. A thread that runs out of chunks steals the
+    remaining chunks of the other threads, so uneven chunks do not leave
+    threads idle. The calling thread takes part in the work.
+
+    \see \ref CompiledNetwork::set(Index, double, ThreadPool&)
+ */
+class ThreadPool
+{
+public:
+  /** Creates a pool that runs loops on threadCount threads in total,
+      including the calling thread.
+   */
+  explicit ThreadPool(unsigned int threadCount);
+  ~ThreadPool();
+
+  unsigned int getThreadCount() const;
+
+  /** Runs body(begin, end) for consecutive chunks covering [0, count) and
+      returns when all chunks are done. Calls may not be nested.
+   */
+  void parallelFor(std::size_t count,
+                   std::size_t chunkSize,
+                   const std::function<void(std::size_t, std::size_t)>& body);
+
+private:
+  ThreadPool(const ThreadPool&) = delete;
+  void operator=(const ThreadPool&) = delete;
+
+  /** The chunks initially assigned to one thread. */
+  struct Share
+  {
+    std::atomic<std::size_t> next;
+    std::size_t end;
+  };
+
+  void work(unsigned int thread);
+  void workerLoop(unsigned int thread);
+
+private:
+  std::vector<std::thread> mThreads;
+  std::unique_ptr<Share[]> mShares;
+  unsigned int mThreadCount;
+
+  std::mutex mMutex;
+  std::condition_variable mStart;
+  std::condition_variable mDone;
+  unsigned long long mGeneration = 0;
+  unsigned int mBusy = 0;
+  bool mStopping = false;
+
+  // The current loop
+  const std::function<void(std::size_t, std::size_t)>* mBody = nullptr;
+  std::size_t mCount = 0;
+  std::size_t mChunkSize = 1;
+};
+
+}}
@@ -0,0 +1,154 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Trace.h"
+
+#include "IOperation.h"
+#include "Wire.h"
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+using common::constraints::TraceEvent;
+
+const char* getCategory(TraceEvent::Kind kind)
+{
+  switch (kind)
+  {
+  case TraceEvent::PROPAGATE:
+    return "propagateValue";
+  case TraceEvent::RANGE:
+    return "range";
+  case TraceEvent::EXPRESSION:
+    return "expression";
+  }
+  return "";
+}
+
+/** Rounds up to a power of two, so that positions wrap with a mask. */
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+  std::size_t size = 1;
+  while (size < value)
+  {
+    size *= 2;
+  }
+  return size;
+}
+
+void writeEscaped(std::ostream& s, const std::string& text)
+{
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      s << '\\' << c;
+    }
+    else if (c == '\n')
+    {
+      s << "\\n";
+    }
+    else
+    {
+      s << c;
+    }
+  }
+}
+
+}
+
+namespace common { namespace constraints {
+
+TraceBuffer::TraceBuffer(std::size_t capacity)
+  : mSlots(roundUpToPowerOfTwo(capacity))
+  , mMask(mSlots.size() - 1)
+  , mRecorded(0)
+{
+}
+
+void TraceBuffer::record(const TraceEvent& event)
+{
+  const unsigned long long index =
+    mRecorded.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = mSlots[static_cast<std::size_t>(index) & mMask];
+
+  // Claim the slot, unless another event is being written to it or a newer
+  // one has already been published
+  unsigned long long sequence = slot.sequence.load(std::memory_order_relaxed);
+  do
+  {
+    if ((sequence & 1) != 0 || sequence > 2 * index)
+    {
+      return;
+    }
+  } while (!slot.sequence.compare_exchange_weak(
+    sequence, 2 * index + 1, std::memory_order_acquire));
+
+  slot.event = event;
+  slot.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+std::vector<TraceEvent> TraceBuffer::getEvents() const
+{
+  const unsigned long long recorded = mRecorded.load();
+  const unsigned long long first =
+    recorded > mSlots.size() ? recorded - mSlots.size() : 0;
+  std::vector<TraceEvent> events;
+  events.reserve(static_cast<std::size_t>(recorded - first));
+  for (unsigned long long index = first; index < recorded; ++index)
+  {
+    // Skips events that were dropped
+    const Slot& slot = mSlots[static_cast<std::size_t>(index) & mMask];
+    if (slot.sequence.load(std::memory_order_acquire) == 2 * (index + 1))
+    {
+      events.push_back(slot.event);
+    }
+  }
+  return events;
+}
+
+void TraceBuffer::clear()
+{
+  for (auto& slot : mSlots)
+  {
+    slot.sequence = 0;
+  }
+  mRecorded = 0;
+}
+
+void TraceBuffer::exportChromeTrace(std::ostream& s) const
+{
+  // Complete events with timestamps and durations in microseconds
+  const std::ios_base::fmtflags flags = s.flags();
+  const std::streamsize precision = s.precision();
+  s << std::fixed << std::setprecision(3);
+  s << "{\"traceEvents\":[";
+  const char* separator = "\n";
+  for (auto& event : getEvents())
+  {
+    s << separator << "{\"name\":\"";
+    writeEscaped(s,
+                 event.operation != nullptr ? event.operation->getName()
+                                            : event.wire->getName());
+    s << "\",\"cat\":\"" << getCategory(event.kind) << "\",\"ph\":\"X\""
+      << ",\"ts\":" << event.begin / 1000.0
+      << ",\"dur\":" << (event.end - event.begin) / 1000.0
+      << ",\"pid\":1,\"tid\":1}";
+    separator = ",\n";
+  }
+  s << "\n]}\n";
+  s.flags(flags);
+  s.precision(precision);
+}
+
+unsigned long long TraceBuffer::now()
+{
+  return static_cast<unsigned long long>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+}}
@@ -0,0 +1,143 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Forward-declares std::ostream
+#include <iosfwd>
+
+/** Expands to its arguments only when tracing is enabled, so that the hooks
+    compile to nothing otherwise.
+ */
+#if defined(CONSTRAINTS_ENABLE_TRACING)
+#define CONSTRAINTS_TRACE(...) __VA_ARGS__
+#else
+#define CONSTRAINTS_TRACE(...)
+#endif
+
+namespace common { namespace constraints {
+
+class IOperation;
+class Wire;
+
+/** A timed call on an operation or a wire. */
+struct TraceEvent
+{
+  enum Kind
+  {
+    PROPAGATE,
+    RANGE,
+    EXPRESSION
+  };
+
+  Kind kind;
+  /** The operation called, or null if it was a wire. */
+  const IOperation* operation;
+  /** The wire called, or null if it was an operation. */
+  const Wire* wire;
+  /** Start and end of the call in nanoseconds of a monotonic clock. */
+  unsigned long long begin;
+  unsigned long long end;
+};
+
+/** Fixed-size ring buffer of trace events, where the newest events replace
+    the oldest ones.
+
+    Recording is lock-free, so several networks on different threads may
+    share a buffer. Each event claims the next position with an atomic
+    counter, and its slot is only published once the event is written. An
+    event is dropped if its slot is still being written by an event from the
+    previous round, which only happens when more events are recorded
+    concurrently than the buffer holds. Reading, exporting and clearing must
+    not run concurrently with recording. Events refer to their operations
+    and wires, so the buffer must be exported while the network is alive.
+
+    Tracing is only recorded if the library is built with
+    CONSTRAINTS_ENABLE_TRACING defined.
+
+    \see \ref Network::setTraceBuffer
+ */
+class TraceBuffer
+{
+public:
+  /** Creates a buffer holding at least the given number of events. */
+  explicit TraceBuffer(std::size_t capacity);
+
+  void record(const TraceEvent& event);
+  /** Gets the recorded events, oldest first. */
+  std::vector<TraceEvent> getEvents() const;
+  void clear();
+
+  /** Writes the events in the Chrome trace event format, which can be
+      loaded in chrome://tracing or Perfetto.
+   */
+  void exportChromeTrace(std::ostream& s) const;
+
+  /** Gets the current time of the clock used for events. */
+  static unsigned long long now();
+
+private:
+  TraceBuffer(const TraceBuffer&) = delete;
+  void operator=(const TraceBuffer&) = delete;
+
+  /** An event with the state of its slot: zero if empty, odd while an event
+      is written, and twice one more than the position of the event once it
+      is published.
+   */
+  struct Slot
+  {
+    Slot()
+      : sequence(0)
+    {
+    }
+
+    std::atomic<unsigned long long> sequence;
+    TraceEvent event;
+  };
+
+private:
+  std::vector<Slot> mSlots;
+  std::size_t mMask;
+  std::atomic<unsigned long long> mRecorded;
+};
+
+/** Records an event covering its own lifetime, if given a buffer. */
+class TraceScope
+{
+public:
+  TraceScope(TraceBuffer* buffer,
+             TraceEvent::Kind kind,
+             const IOperation* operation,
+             const Wire* wire)
+    : mBuffer(buffer)
+  {
+    if (mBuffer != nullptr)
+    {
+      mEvent.kind = kind;
+      mEvent.operation = operation;
+      mEvent.wire = wire;
+      mEvent.begin = TraceBuffer::now();
+    }
+  }
+
+  ~TraceScope()
+  {
+    if (mBuffer != nullptr)
+    {
+      mEvent.end = TraceBuffer::now();
+      mBuffer->record(mEvent);
+    }
+  }
+
+private:
+  TraceScope(const TraceScope&) = delete;
+  void operator=(const TraceScope&) = delete;
+
+private:
+  TraceBuffer* mBuffer;
+  TraceEvent mEvent;
+};
+
+}}
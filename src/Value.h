@@ -0,0 +1,36 @@
+// Copyright 2019 SICK AG. All rights reserved.
+#pragma once
+
+#if defined(CONSTRAINTS_VALUE_FLOAT) && defined(CONSTRAINTS_VALUE_FIXED)
+#error "Only one value type can be selected"
+#endif
+
+#if defined(CONSTRAINTS_VALUE_FIXED)
+#include "Fixed.h"
+#endif
+
+namespace common { namespace constraints {
+
+/** The number type of wire values, ranges and expressions.
+
+    The type is chosen when building the library, so that targets without a
+    floating-point unit avoid emulated double arithmetic:
+    - double by default
+    - float if CONSTRAINTS_VALUE_FLOAT is defined
+    - the saturating Q16.16 \ref Fixed if CONSTRAINTS_VALUE_FIXED is defined
+
+    Ranges and inequalities are solved in the same type, so their results are
+    exact up to the rounding of that type. For Fixed, the largest and lowest
+    values stand in for the infinite ends of ranges.
+
+    A CompiledNetwork always evaluates in double.
+ */
+#if defined(CONSTRAINTS_VALUE_FLOAT)
+typedef float Value;
+#elif defined(CONSTRAINTS_VALUE_FIXED)
+typedef Fixed Value;
+#else
+typedef double Value;
+#endif
+
+}}
@@ -1,42 +1,77 @@
 // Copyright 2019 SICK AG. All rights reserved.
 #include "Wire.h"
 
+#include "Exporter.h"
+#include "LinearCombination.h"
 #include "Network.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <limits>
 #include <sstream>
 
-namespace {
-
-std::string toString(double v)
-{
-  std::ostringstream s;
-  s << v;
-  return s.str();
-}
-
-}
-
 namespace common { namespace constraints {
 
-double Wire::get() const
+Value Wire::get() const
 {
+  if (mDetached)
+  {
+    if (mNetwork.mProbing)
+    {
+      return mCombination->evaluate();
+    }
+    if (!isEvaluated())
+    {
+      mEvaluated = mCombination->evaluate();
+      mEvaluatedEpoch = mNetwork.mValueEpoch;
+    }
+    return mEvaluated;
+  }
+  if (mDirty)
+  {
+    mNetwork.refresh(*this);
+  }
+  if (mNetwork.mProbing && mProbeEpoch == mNetwork.mPropagationEpoch)
+  {
+    return mProbeValue;
+  }
   return mValue;
 }
 
-Result Wire::set(double value)
+Result Wire::set(Value value)
 {
+  CONSTRAINTS_STATS(++mNetwork.mStats.wiresWritten;)
+  // Constants are shared by every operation using the same literal value,
+  // so changing one would change all of them
+  if (mConstant && value != mValue)
+  {
+    Result result(false);
+    result.rejectConstant(this);
+    return result;
+  }
+  if (mNetwork.mProbing)
+  {
+    mProbeValue = value;
+    mProbeEpoch = mNetwork.mPropagationEpoch;
+    return propagateValue();
+  }
+  mNetwork.recordChange(*this);
   mValue = value;
   return propagateValue();
 }
 
 Range Wire::range() const
 {
+  mNetwork.beginQuery();
+  CONSTRAINTS_STATS(++mNetwork.mStats.rangeQueries;)
+  CONSTRAINTS_TRACE(
+    TraceScope trace(mNetwork.mTrace, TraceEvent::RANGE, nullptr, this);)
   return range(*this);
 }
 
 WireExpression Wire::expression(const IWire& variable) const
 {
+  CONSTRAINTS_STATS(++mNetwork.mStats.expressionCalls;)
   if (&variable == this)
   {
     return WireExpression::createLinear(1, 0);
@@ -45,22 +80,17 @@ WireExpression Wire::expression(const IWire& variable) const
   {
     return WireExpression::createLinear(0, get());
   }
-  else
+  else if (!mNetwork.hasExpression(*this, variable))
   {
-    return mDriver->expression(variable);
+    mNetwork.computeExpressions(*this, variable);
   }
+  return mExpression;
 }
 
 std::string Wire::dump(unsigned int indentationLevel) const
 {
   std::ostringstream s;
-  s << std::string(indentationLevel * 2, ' ') << getName();
-  s << " with value " << mValue;
-  s << " and range " << range() << std::endl;
-  for (auto operation : mOperations)
-  {
-    s << operation->dump(indentationLevel + 1);
-  }
+  Exporter(*this, false).writeText(s, indentationLevel);
   return s.str();
 }
 
@@ -68,62 +98,67 @@ std::string Wire::dump(unsigned int indentationLevel) const
 std::string Wire::getShortDescription() const
 {
   std::ostringstream s;
-  s << "(" << getName() << ")=" << mValue;
+  s << "(" << getName() << ")=" << get();
   return s.str();
 }
 
 std::string Wire::getName() const
 {
-  std::ostringstream s;
-  if (!mName.empty())
-  {
-    s << mName;
-    if (mDriver != nullptr)
-    {
-      s << ": ";
-    }
-  }
-  if (mDriver != nullptr)
-  {
-    s << mDriver->getName();
-  }
-  return s.str();
+  return NameWriter::getName(*this);
+}
+
+bool Wire::isConstant() const
+{
+  return mConstant;
 }
 
-Result Wire::operator=(double value)
+Result Wire::check(Value value) const
+{
+  return mNetwork.probe(*this, value);
+}
+
+Result Wire::operator=(Value value)
 {
   return set(value);
 }
 
 Wire& Wire::operator+(Wire& other)
 {
-  return mNetwork.add(*this, other);
+  return mNetwork.combine(*this, 1, &other, 1, 0);
 }
 
-Wire& Wire::operator+(double other)
+Wire& Wire::operator+(Value other)
 {
-  return *this + mNetwork.make(toString(other), other);
+  return mNetwork.combine(*this, 1, nullptr, 0, other);
 }
 
-Wire& Wire::operator-(double other)
+Wire& Wire::operator-(Value other)
 {
   return *this + (-other);
 }
 
 Wire& Wire::operator*(Wire& other)
 {
+  if (other.mConstant)
+  {
+    return *this * other.mValue;
+  }
+  if (mConstant)
+  {
+    return other * mValue;
+  }
   return mNetwork.multiply(*this, other);
 }
 
-Wire& Wire::operator*(double other)
+Wire& Wire::operator*(Value other)
 {
-  return *this * mNetwork.make(toString(other), other);
+  return mNetwork.combine(*this, other, nullptr, 0, 0);
 }
 
 
-Wire& Wire::operator/(double other)
+Wire& Wire::operator/(Value other)
 {
-  return *this * (1 / other);
+  return *this * (Value(1) / other);
 }
 
 LessOrEqual& Wire::operator<=(Wire& other)
@@ -131,9 +166,9 @@ LessOrEqual& Wire::operator<=(Wire& other)
   return mNetwork.lessOrEqual(*this, other);
 }
 
-LessOrEqual& Wire::operator<=(double other)
+LessOrEqual& Wire::operator<=(Value other)
 {
-  return *this <= mNetwork.make(toString(other), other);
+  return *this <= mNetwork.constant(other);
 }
 
 LessOrEqual& Wire::operator>=(Wire& other)
@@ -141,9 +176,24 @@ LessOrEqual& Wire::operator>=(Wire& other)
   return other <= *this;
 }
 
-LessOrEqual& Wire::operator>=(double other)
+LessOrEqual& Wire::operator>=(Value other)
+{
+  return *this >= mNetwork.constant(other);
+}
+
+Bounds& Wire::within(Value lower, Value upper)
+{
+  return mNetwork.bounds(*this, lower, upper);
+}
+
+Equal& Wire::equals(Wire& other, Value tolerance)
+{
+  return mNetwork.equal(*this, other, tolerance);
+}
+
+Equal& Wire::equals(Value other, Value tolerance)
 {
-  return *this >= mNetwork.make(toString(other), other);
+  return equals(mNetwork.constant(other), tolerance);
 }
 
 // ----------------------------------------------------------------------------
@@ -152,37 +202,97 @@ LessOrEqual& Wire::operator>=(double other)
 Wire::Wire(Network& network)
   : mNetwork(network)
   , mDriver(nullptr)
-  , mValue(0.0)
+  , mValue(0)
+  , mRank(0)
+  , mConstant(false)
+  , mCombination(nullptr)
+  , mDetached(false)
+  , mEvaluated(0)
+  , mEvaluatedEpoch(std::numeric_limits<unsigned long long>::max())
+  , mDirty(false)
+  , mPinned(false)
+  , mProbeValue(0)
+  , mProbeEpoch(0)
+  , mSavedValue(0)
+  , mSavedTransaction(0)
+  , mNextChanged(nullptr)
+  , mExpression(WireExpression::createLinear(0, 0))
+  , mExpressionVariable(nullptr)
+  , mExpressionValueEpoch(0)
+  , mExpressionQuery(0)
+  , mRangeWalk(0)
+  , mName(nullptr)
+  , mOperations(ArenaAllocator<IOperation*>(network.mArena))
+  , mRelations(ArenaAllocator<const IOperation*>(network.mArena))
 {
 }
 
-Wire::Wire(Network& network, double value)
+Wire::Wire(Network& network, Value value)
   : mNetwork(network)
   , mDriver(nullptr)
   , mValue(value)
+  , mRank(0)
+  , mConstant(false)
+  , mCombination(nullptr)
+  , mDetached(false)
+  , mEvaluated(0)
+  , mEvaluatedEpoch(std::numeric_limits<unsigned long long>::max())
+  , mDirty(false)
+  , mPinned(false)
+  , mProbeValue(0)
+  , mProbeEpoch(0)
+  , mSavedValue(0)
+  , mSavedTransaction(0)
+  , mNextChanged(nullptr)
+  , mExpression(WireExpression::createLinear(0, 0))
+  , mExpressionVariable(nullptr)
+  , mExpressionValueEpoch(0)
+  , mExpressionQuery(0)
+  , mRangeWalk(0)
+  , mName(nullptr)
+  , mOperations(ArenaAllocator<IOperation*>(network.mArena))
+  , mRelations(ArenaAllocator<const IOperation*>(network.mArena))
 {
 }
 
 Range Wire::range(const IWire& varyingWire) const
 {
-  Range r;
-  for (auto operation : mOperations)
-  {
-    r = Range::intersect(r, operation->range(varyingWire));
-  }
-  return r;
+  return mNetwork.rangeDownstream(*this, varyingWire);
 }
 
 void Wire::connect(IOperation* operation)
 {
+  if (mDetached)
+  {
+    mNetwork.reconnect(*this);
+  }
+  // Grow explicitly, so the memory taken from the arena is bounded by the
+  // number of connections on any standard library
+  if (mOperations.size() == mOperations.capacity())
+  {
+    mOperations.reserve(std::max<std::size_t>(4, 2 * mOperations.capacity()));
+  }
   mOperations.push_back(operation);
+  mNetwork.mLongestConnectionList =
+    std::max(mNetwork.mLongestConnectionList, mOperations.size());
+  operation->mRank = std::max(operation->mRank, mRank);
 }
 
+void Wire::disconnect(IOperation* operation)
+{
+  auto found = std::find(mOperations.begin(), mOperations.end(), operation);
+  assert(found != mOperations.end());
+  mOperations.erase(found);
+}
 
 void Wire::setDriver(IOperation* operation)
 {
   assert(mDriver == nullptr);
+  // Ranks of downstream operations are not updated, so the driver must be set
+  // before the wire is connected to anything.
+  assert(mOperations.empty());
   mDriver = operation;
+  mRank = operation->mRank + 1;
 }
 
 Network& Wire::getNetwork() const
@@ -190,42 +300,86 @@ Network& Wire::getNetwork() const
   return mNetwork;
 }
 
+const Wire* Wire::asWire() const
+{
+  return this;
+}
+
+bool Wire::isEvaluated() const
+{
+  // Checks read candidate values, which are not kept
+  return mEvaluatedEpoch == mNetwork.mValueEpoch && !mNetwork.mProbing;
+}
+
 Result Wire::propagateValue()
 {
-  for (auto operation : mOperations)
-  {
-    Result result = operation->propagateValue();
-    if (!result)
-    {
-      return result;
-    }
-  }
-  return Result(true);
+  return mNetwork.propagate(*this);
 }
 
-void Wire::setName(std::string name)
+
+void Wire::setName(const char* name, std::size_t length)
 {
-  mName = name;
+  mName = mNetwork.copyName(name, length);
 }
 
-Wire& operator+(double left, Wire& right)
+Wire& operator+(Value left, Wire& right)
 {
   return right + left;
 }
 
-Wire& operator*(double left, Wire& right)
+Wire& operator*(Value left, Wire& right)
 {
   return right * left;
 }
 
-LessOrEqual& operator<=(double left, Wire& right)
+LessOrEqual& operator<=(Value left, Wire& right)
 {
   return right >= left;
 }
 
-LessOrEqual& operator>=(double left, Wire& right)
+LessOrEqual& operator>=(Value left, Wire& right)
 {
   return right <= left;
 }
 
+Wire& min(Wire& left, Wire& right)
+{
+  return left.mNetwork.minimum(left, right);
+}
+
+Wire& min(Wire& left, Value right)
+{
+  return min(left, left.mNetwork.constant(right));
+}
+
+Wire& min(Value left, Wire& right)
+{
+  return min(right, left);
+}
+
+Wire& max(Wire& left, Wire& right)
+{
+  return left.mNetwork.maximum(left, right);
+}
+
+Wire& max(Wire& left, Value right)
+{
+  return max(left, left.mNetwork.constant(right));
+}
+
+Wire& max(Value left, Wire& right)
+{
+  return max(right, left);
+}
+
+Wire& abs(Wire& wire)
+{
+  return wire.mNetwork.absolute(wire);
+}
+
+Wire& clamp(Wire& wire, Value lower, Value upper)
+{
+  return wire.mNetwork.clamp(wire, lower, upper);
+}
+
 }}
@@ -7,86 +7,212 @@
 #include "Range.h"
 #include "Result.h"
 
-#include <list>
+#include "Arena.h"
+
 #include <memory>
+#include <string>
+#include <vector>
 
 
 namespace common { namespace constraints {
 
+class Bounds;
+class Equal;
 class LessOrEqual;
+class LinearCombination;
 class Network;
 struct Range;
 
 class Wire : public IWire
 {
 public:
-  virtual double get() const override;
-  virtual Result set(double value) override;
+  virtual Value get() const override;
+  virtual Result set(Value value) override;
   virtual Range range() const override;
   virtual WireExpression expression(const IWire& variable) const override;
   virtual std::string dump(unsigned int indentationLevel = 0) const override;
   virtual std::string getShortDescription() const override;
   virtual std::string getName() const override;
 
+  /** Checks whether the wire is a constant from \ref Network::constant. */
+  bool isConstant() const;
+
+  /** Checks whether a value would be allowed, without assigning it. The
+      downstream operations are evaluated against scratch values, so neither
+      this wire nor any other wire in the network is modified.
+      \return a result object to know if the value would be allowed
+   */
+  Result check(Value value) const;
+
   /** Assigns a value to the wire.
       \return a result object to know if the value was allowed
    */
-  Result operator=(double value);
-  /** Creates an addition operation between this wire and another.
-      \return the output wire from the addition
+  Result operator=(Value value);
+  /** Creates a sum of this wire and another.
+      \return the output wire from the sum
+      \see \ref LinearCombination
    */
   Wire& operator+(Wire& other);
-  Wire& operator+(double other);
-  Wire& operator-(double other);
-  /** Creates a multiplication operation between this wire and another.
+  Wire& operator+(Value other);
+  Wire& operator-(Value other);
+  /** Creates a multiplication operation between this wire and another, or a
+      scaled copy of this wire if either is a constant.
       \return the output wire from the multiplication
  */
   Wire& operator*(Wire& other);
-  Wire& operator*(double other);
-  Wire& operator/(double other);
+  Wire& operator*(Value other);
+  Wire& operator/(Value other);
   /** Creates a less-than-or-equal-to relation operation between this wire and
       another.
       \return the operation object
    */
   LessOrEqual& operator<=(Wire& other);
-  LessOrEqual& operator<=(double other);
+  LessOrEqual& operator<=(Value other);
   /** Creates a greater-than-or-equal-to relation operation between this wire
       and another.
       \return the operation object
    */
   LessOrEqual& operator>=(Wire& other);
-  LessOrEqual& operator>=(double other);
+  LessOrEqual& operator>=(Value other);
+  /** Creates a window relation lower <= this <= upper.
+      \return the operation object
+   */
+  Bounds& within(Value lower, Value upper);
+  /** Creates an equality relation between this wire and another, which
+      holds if they differ by at most the tolerance.
+      \return the operation object
+   */
+  Equal& equals(Wire& other, Value tolerance = 0);
+  Equal& equals(Value other, Value tolerance = 0);
 
 private:
   Wire(const Wire&) = delete;
   void operator=(const Wire&) = delete;
 
   Wire(Network& network);
-  Wire(Network& network, double value);
+  Wire(Network& network, Value value);
 
   virtual Range range(const IWire& wire) const override;
   virtual void connect(IOperation* operation) override;
+  virtual void disconnect(IOperation* operation) override;
   virtual void setDriver(IOperation* operation) override;
   virtual Network& getNetwork() const override;
+  virtual const Wire* asWire() const override;
+  /** Checks whether the value of a detached wire is known from an earlier
+      read, so that it is not evaluated again. Reading the sums of a merged
+      chain in the order they were built, as compiling does, then takes
+      linear time.
+   */
+  bool isEvaluated() const;
   Result propagateValue();
-  void setName(std::string name);
+  /** Copies the name into the memory of the network. */
+  void setName(const char* name, std::size_t length);
 
 private:
   Network& mNetwork;
   IOperation* mDriver;
-  double mValue;
-  std::string mName;
-  std::list<IOperation*> mOperations;
+  Value mValue;
+  /** Topological rank; zero for undriven wires, otherwise one more than the
+      rank of the driver.
+   */
+  unsigned int mRank;
+  /** Whether the wire is shared from the constant pool of the network. */
+  bool mConstant;
+  /** The linear combination driving the wire, or null. */
+  LinearCombination* mCombination;
+  /** Whether the driving linear combination has been merged into the one
+      consumer of this wire by \ref Network::optimize, so that it is
+      disconnected from its inputs and the value of this wire is computed
+      when read.
+   */
+  bool mDetached;
+  /** Value of a detached wire when it was last read, which stays valid
+      until any wire changes, see \ref isEvaluated.
+   */
+  mutable Value mEvaluated;
+  mutable unsigned long long mEvaluatedEpoch;
+  /** Whether lazy evaluation has deferred the driver since it last computed
+      the value, so that the value is computed when read.
+   */
+  mutable bool mDirty;
+  /** Whether the application reads the wire, see \ref Network::pin. */
+  bool mPinned;
+  /** Scratch value used while checking a candidate value. It is only valid
+      during the propagation it was stamped with.
+   */
+  mutable Value mProbeValue;
+  mutable unsigned long long mProbeEpoch;
+  /** Value from before the transaction the wire was last changed in, and the
+      next wire changed in the same transaction.
+   */
+  Value mSavedValue;
+  unsigned long long mSavedTransaction;
+  Wire* mNextChanged;
+  /** Expression of this wire as a function of mExpressionVariable, memoized
+      so that shared subexpressions are only computed once per range query.
+   */
+  mutable WireExpression mExpression;
+  mutable const IWire* mExpressionVariable;
+  mutable unsigned long long mExpressionValueEpoch;
+  mutable unsigned long long mExpressionQuery;
+  /** The range query walk that last reached this wire. */
+  mutable unsigned long long mRangeWalk;
+  /** Null-terminated name, or null if the wire has no name. */
+  const char* mName;
+  std::vector<IOperation*, ArenaAllocator<IOperation*>> mOperations;
+  /** Relations downstream of the wire in the order they were created, see
+      \ref Network::indexRelations.
+   */
+  std::vector<const IOperation*, ArenaAllocator<const IOperation*>> mRelations;
 
   // Allow network factory functions to create wires
   friend class Network;
+  // Allow merged sums to be evaluated when read
+  friend class LinearCombination;
   friend class WireTest;
+  friend class LinearCombinationTest;
+  // Allow exporter to walk the network
+  friend class Exporter;
+  // Allow name writer to expand the names of drivers
+  friend class NameWriter;
+  // Allow piecewise functions to create operations in the network
+  friend Wire& min(Wire& left, Wire& right);
+  friend Wire& min(Wire& left, Value right);
+  friend Wire& max(Wire& left, Wire& right);
+  friend Wire& max(Wire& left, Value right);
+  friend Wire& abs(Wire& wire);
+  friend Wire& clamp(Wire& wire, Value lower, Value upper);
 };
 
 /** Reversed variants for creating operations with literal values */
-Wire& operator+(double left, Wire& right);
-Wire& operator*(double left, Wire& right);
-LessOrEqual& operator<=(double left, Wire& right);
-LessOrEqual& operator>=(double left, Wire& right);
+Wire& operator+(Value left, Wire& right);
+Wire& operator*(Value left, Wire& right);
+LessOrEqual& operator<=(Value left, Wire& right);
+LessOrEqual& operator>=(Value left, Wire& right);
+
+/** Creates an operation giving the smaller of two values.
+    \return the output wire from the operation
+    \see \ref Min
+ */
+Wire& min(Wire& left, Wire& right);
+Wire& min(Wire& left, Value right);
+Wire& min(Value left, Wire& right);
+/** Creates an operation giving the larger of two values.
+    \return the output wire from the operation
+    \see \ref Max
+ */
+Wire& max(Wire& left, Wire& right);
+Wire& max(Wire& left, Value right);
+Wire& max(Value left, Wire& right);
+/** Creates an operation giving the absolute value of a wire.
+    \return the output wire from the operation
+    \see \ref Abs
+ */
+Wire& abs(Wire& wire);
+/** Creates an operation limiting a wire to lower <= wire <= upper.
+    \return the output wire from the operation
+    \see \ref Clamp
+ */
+Wire& clamp(Wire& wire, Value lower, Value upper);
 
 }}
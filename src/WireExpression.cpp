@@ -4,7 +4,7 @@
 
 namespace common { namespace constraints {
 
-WireExpression WireExpression::createLinear(double firstDegree, double constant)
+WireExpression WireExpression::createLinear(Value firstDegree, Value constant)
 {
   return WireExpression(firstDegree, constant, false);
 }
@@ -13,37 +13,42 @@ WireExpression WireExpression::operator+(const WireExpression& other) const
 {
   return WireExpression(firstDegree + other.firstDegree,
                         constant + other.constant,
-                        nonlinear || other.nonlinear);
+                        nonlinear || other.nonlinear,
+                        Range::intersect(domain, other.domain));
 }
 
 WireExpression WireExpression::operator-(const WireExpression& other) const
 {
   return WireExpression(firstDegree - other.firstDegree,
                         constant - other.constant,
-                        nonlinear || other.nonlinear);
+                        nonlinear || other.nonlinear,
+                        Range::intersect(domain, other.domain));
 }
 
 WireExpression WireExpression::operator*(const WireExpression& other) const
 {
-  double secondDegree = firstDegree * other.firstDegree;
+  const bool secondDegree = firstDegree * other.firstDegree != Value(0);
   return WireExpression(firstDegree * other.constant
                           + constant * other.firstDegree,
                         constant * other.constant,
-                        nonlinear || other.nonlinear || secondDegree != 0.0);
+                        nonlinear || other.nonlinear || secondDegree,
+                        Range::intersect(domain, other.domain));
 }
 
 bool WireExpression::operator==(const WireExpression& other) const
 {
   return firstDegree == other.firstDegree && constant == other.constant
-         && nonlinear == other.nonlinear;
+         && nonlinear == other.nonlinear && domain == other.domain;
 }
 
-WireExpression::WireExpression(double firstDegree,
-                               double constant,
-                               bool nonlinear)
+WireExpression::WireExpression(Value firstDegree,
+                               Value constant,
+                               bool nonlinear,
+                               const Range& domain)
   : constant(constant)
   , firstDegree(firstDegree)
   , nonlinear(nonlinear)
+  , domain(domain)
 {
 }
 
@@ -62,6 +67,10 @@ std::ostream& operator<<(std::ostream& s, const WireExpression& expression)
   {
     s << " + a_nonlinear_term";
   }
+  if (expression.domain != Range::FULL)
+  {
+    s << " for x in " << expression.domain;
+  }
   return s;
 }
 
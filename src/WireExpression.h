@@ -2,18 +2,23 @@
 
 #pragma once
 
+#include "Range.h"
+#include "Value.h"
+
 #include <ostream>
 
 namespace common { namespace constraints {
 
 /** Models an expression firstDegree * x + constant + a_nonlinear_function(x) of
-    some variable x.
+    some variable x. Piecewise operations describe only the piece that holds
+    for the current value of x; the domain bounds the values of x for which
+    this piece is valid.
  */
 struct WireExpression
 {
 public:
   /** Factory function to create a linear expression. */
-  static WireExpression createLinear(double firstDegree, double constant);
+  static WireExpression createLinear(Value firstDegree, Value constant);
 
   /** Forms a new expression s(x) which represents the sum of two expressions
       e1(x) and e2(x) such that s(x) = e1(x) + e2(x) */
@@ -26,17 +31,23 @@ public:
       expressions e1(x) and e2(x) such that d(x) = e1(x) * e2(x)
    */
   WireExpression operator*(const WireExpression& other) const;
-  /** Checks for expression equality, i.e., if all coefficients are equal.
+  /** Checks for expression equality, i.e., if all coefficients and the
+      domains are equal.
    */
   bool operator==(const WireExpression& other) const;
 
 public:
-  double constant;
-  double firstDegree;
+  Value constant;
+  Value firstDegree;
   bool nonlinear;
+  /** The values of x for which the expression holds. */
+  Range domain;
 
 private:
-  WireExpression(double firstDegree, double constant, bool nonlinear);
+  WireExpression(Value firstDegree,
+                 Value constant,
+                 bool nonlinear,
+                 const Range& domain = Range::FULL);
 
   friend class WireExpressionTest;
   friend class LessOrEqualTest;
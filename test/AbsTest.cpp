@@ -0,0 +1,70 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Abs.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class AbsTest : public ::testing::Test
+{
+protected:
+  Network mNetwork;
+};
+
+TEST_F(AbsTest, valueIsTheMagnitude)
+{
+  Wire& a = mNetwork.make("A", -3);
+  Wire& magnitude = abs(a);
+  ASSERT_EQ(magnitude.get(), 3);
+  ASSERT_TRUE(a.set(2));
+  ASSERT_EQ(magnitude.get(), 2);
+  ASSERT_EQ(magnitude.getName(), "abs(A)");
+  ASSERT_EQ(abs(mNetwork.constant(-4)).get(), 4);
+}
+
+TEST_F(AbsTest, deviationStaysUnderLimit)
+{
+  Wire& a = mNetwork.make("A", 4);
+  abs(a - 5) <= 2;
+  ASSERT_TRUE(a.set(3));
+  ASSERT_TRUE(a.set(7));
+  ASSERT_FALSE(a.set(8));
+  ASSERT_FALSE(a.set(2));
+}
+
+TEST_F(AbsTest, rangeFollowsTheSignOfTheInput)
+{
+  Wire& a = mNetwork.make("A", 6);
+  abs(a - 5) <= 2;
+  // Each range is limited to the side of zero the input is on
+  ASSERT_EQ(a.range(), Range(5, 7));
+
+  ASSERT_TRUE(a.set(4));
+  ASSERT_EQ(a.range(), Range(3, 5));
+  ASSERT_EQ(mNetwork.computeAllRanges()[&a], a.range());
+}
+
+TEST_F(AbsTest, rangeExcludesViolationsOnTheOtherSide)
+{
+  Wire& x = mNetwork.make("X", 2);
+  abs(x) <= 3;
+  ASSERT_EQ(x.range(), Range(0, 3));
+  ASSERT_FALSE(x.set(-5));
+}
+
+TEST_F(AbsTest, compiledNetworkMatches)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& magnitude = abs(a);
+  magnitude <= 2;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), -2));
+  ASSERT_EQ(compiled.get(compiled.indexOf(magnitude)), 2);
+  ASSERT_FALSE(compiled.set(compiled.indexOf(a), -3));
+}
+
+}}
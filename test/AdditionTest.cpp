@@ -5,6 +5,7 @@
 #include "Wire.h"
 
 #include "commonconstraintsMockWire.h"
+#include "commonconstraintsTolerance.h"
 
 #include <gtest/gtest.h>
 
@@ -38,7 +39,7 @@ TEST_F(AdditionTest, onePlusOneEqualsTwo)
 TEST_F(AdditionTest, addNegativeFraction)
 {
   Wire& sum = mNetwork.add(mNetwork.make(2), mNetwork.make(-1.7));
-  ASSERT_NEAR(sum.get(), 0.3, 1e-7);
+  ASSERT_NEAR(static_cast<double>(sum.get()), 0.3, TOLERANCE);
 }
 
 TEST_F(AdditionTest, addThreeWires)
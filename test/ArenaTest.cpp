@@ -0,0 +1,57 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Arena.h"
+
+#include "commonconstraintsCountingResource.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace common { namespace constraints {
+
+TEST(ArenaTest, smallAllocationsShareABlock)
+{
+  CountingResource resource;
+  {
+    Arena arena(resource);
+    for (int i = 0; i < 100; ++i)
+    {
+      ASSERT_NE(arena.allocate(16, 8), nullptr);
+    }
+    ASSERT_EQ(resource.allocations, 1);
+  }
+  ASSERT_EQ(resource.deallocations, 1);
+}
+
+TEST(ArenaTest, allocationsAreAligned)
+{
+  Arena arena;
+  arena.allocate(1, 1);
+  void* pointer = arena.allocate(8, 8);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(pointer) % 8, 0u);
+}
+
+TEST(ArenaTest, oversizedAllocation)
+{
+  CountingResource resource;
+  Arena arena(resource);
+  char* pointer = static_cast<char*>(arena.allocate(100000, 8));
+  ASSERT_NE(pointer, nullptr);
+  pointer[99999] = 1;
+  ASSERT_GE(arena.getReservedBytes(), 100000u);
+}
+
+TEST(ArenaTest, allocatorForContainers)
+{
+  Arena arena;
+  std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+  for (int i = 0; i < 1000; ++i)
+  {
+    values.push_back(i);
+  }
+  ASSERT_EQ(values[999], 999);
+}
+
+}}
@@ -0,0 +1,119 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Bounds.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class BoundsTest : public ::testing::Test
+{
+public:
+  Range range(Bounds& bounds, Wire& wire) { return bounds.range(wire); }
+  Range solve(WireExpression expression, Value lower, Value upper)
+  {
+    return Bounds::solve(expression, lower, upper);
+  }
+
+protected:
+  Network mNetwork;
+};
+
+TEST_F(BoundsTest, valueWithinBounds)
+{
+  Wire& x = mNetwork.make(5);
+
+  // No assertion should fail
+  x.within(0, 10);
+  x.within(5, 5);
+}
+
+TEST_F(BoundsTest, valueOutsideBounds)
+{
+  Wire& x = mNetwork.make(42);
+  ASSERT_DEATH(x.within(0, 10), ".*");
+}
+
+TEST_F(BoundsTest, checksBothLimits)
+{
+  Wire& x = mNetwork.make(5);
+  x.within(0, 10);
+  ASSERT_TRUE(x.set(0));
+  ASSERT_TRUE(x.set(10));
+  ASSERT_FALSE(x.set(-0.1));
+  ASSERT_FALSE(x.set(10.1));
+}
+
+TEST_F(BoundsTest, rangeOfWire)
+{
+  Wire& x = mNetwork.make(5);
+  Bounds& bounds = x.within(-1, 10);
+  ASSERT_EQ(range(bounds, x), Range(-1, 10));
+  ASSERT_EQ(x.range(), Range(-1, 10));
+}
+
+TEST_F(BoundsTest, rangeThroughScaledSum)
+{
+  Wire& x = mNetwork.make("X", 1);
+  Wire& y = mNetwork.make("Y", 2);
+  Wire& sum = x * -2 + y;
+  sum.within(-10, 10);
+  ASSERT_EQ(x.range(), Range(-4, 6));
+  ASSERT_EQ(y.range(), Range(-8, 12));
+}
+
+TEST_F(BoundsTest, solve)
+{
+  ASSERT_EQ(solve(WireExpression::createLinear(2, 1), -1, 5), Range(-1, 2));
+  ASSERT_EQ(solve(WireExpression::createLinear(-2, 1), -1, 5), Range(-2, 1));
+  ASSERT_EQ(solve(WireExpression::createLinear(0, 1), -1, 5), Range::FULL);
+  ASSERT_TRUE(solve(WireExpression::createLinear(0, 6), -1, 5).isEmpty());
+  ASSERT_EQ(solve(WireExpression::createLinear(-1, 0),
+                  Range::NEGATIVE_INFINITY,
+                  3),
+            Range(-3, Range::POSITIVE_INFINITY));
+}
+
+TEST_F(BoundsTest, sameRangeAsTwoComparisons)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& y = network.make("Y", 2);
+  Wire& product = x * y;
+  network.lessOrEqual(network.constant(-3), product);
+  product <= 7;
+  Wire& other = mNetwork.make("X", 1);
+  (other * mNetwork.make("Y", 2)).within(-3, 7);
+  ASSERT_EQ(other.range(), x.range());
+}
+
+TEST_F(BoundsTest, name)
+{
+  Wire& x = mNetwork.make("X", 5);
+  Bounds& bounds = x.within(0, 10);
+  ASSERT_EQ(bounds.getName(), "0 <= X <= 10");
+  ASSERT_FALSE(x.set(11));
+  ASSERT_EQ(x.set(11).getErrorMessage(), "0 <= X <= 10 would fail.");
+}
+
+TEST_F(BoundsTest, compiled)
+{
+  Wire& x = mNetwork.make("X", 5);
+  (x + 1).within(0, 10);
+  CompiledNetwork compiled = mNetwork.compile();
+  const CompiledNetwork::Index index = compiled.indexOf(x);
+  ASSERT_TRUE(compiled.set(index, -1));
+  ASSERT_FALSE(compiled.set(index, 10));
+
+  const double values[] = {-2, -1, 9, 10};
+  CompiledNetwork::BatchResult batch =
+    compiled.evaluateBatch({index}, {values}, 4);
+  ASSERT_FALSE(batch.hasPassed(0));
+  ASSERT_TRUE(batch.hasPassed(1));
+  ASSERT_TRUE(batch.hasPassed(2));
+  ASSERT_FALSE(batch.hasPassed(3));
+  ASSERT_EQ(mNetwork.computeAllRanges()[&x], Range(-1, 9));
+}
+
+}}
@@ -0,0 +1,79 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Clamp.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class ClampTest : public ::testing::Test
+{
+protected:
+  Network mNetwork;
+};
+
+TEST_F(ClampTest, valueIsLimited)
+{
+  Wire& a = mNetwork.make("A", 5);
+  Wire& clamped = clamp(a, 0, 10);
+  ASSERT_EQ(clamped.get(), 5);
+  ASSERT_TRUE(a.set(-3));
+  ASSERT_EQ(clamped.get(), 0);
+  ASSERT_TRUE(a.set(12));
+  ASSERT_EQ(clamped.get(), 10);
+  ASSERT_EQ(clamped.getName(), "clamp(A, 0, 10)");
+  ASSERT_TRUE(clamp(mNetwork.constant(12), 0, 10).isConstant());
+}
+
+TEST_F(ClampTest, invalidLimits)
+{
+  Wire& a = mNetwork.make("A", 5);
+  ASSERT_DEATH(clamp(a, 10, 0), ".*");
+}
+
+TEST_F(ClampTest, relationOnClampedValue)
+{
+  Wire& a = mNetwork.make("A", 5);
+  Wire& b = mNetwork.make("B", 1);
+  clamp(a, 0, 10) + b <= 11;
+  ASSERT_TRUE(a.set(100));
+  ASSERT_TRUE(b.set(0));
+  ASSERT_FALSE(b.set(2));
+}
+
+TEST_F(ClampTest, rangeFollowsTheActivePiece)
+{
+  Wire& a = mNetwork.make("A", 5);
+  Wire& b = mNetwork.make("B", 2);
+  clamp(a, 0, 10) + b <= 11;
+  // Between the limits, the range of the input stays between them
+  ASSERT_EQ(a.range(), Range(0, 9));
+  ASSERT_EQ(b.range(), Range(Range::NEGATIVE_INFINITY, 6));
+
+  // At a limit, the clamped value is constant up to that limit
+  ASSERT_TRUE(a.set(-1));
+  ASSERT_EQ(a.range(), Range(Range::NEGATIVE_INFINITY, 0));
+  ASSERT_EQ(b.range(), Range(Range::NEGATIVE_INFINITY, 11));
+
+  auto ranges = mNetwork.computeAllRanges();
+  ASSERT_EQ(ranges[&a], a.range());
+  ASSERT_EQ(ranges[&b], b.range());
+}
+
+TEST_F(ClampTest, compiledNetworkMatches)
+{
+  Wire& a = mNetwork.make("A", 5);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& clamped = clamp(a, 0, 10);
+  clamped + b <= 11;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(b), 1));
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), 20));
+  ASSERT_EQ(compiled.get(compiled.indexOf(clamped)), 10);
+  ASSERT_FALSE(compiled.set(compiled.indexOf(b), 2));
+}
+
+}}
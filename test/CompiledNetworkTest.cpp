@@ -0,0 +1,284 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "CompiledNetwork.h"
+
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+namespace common { namespace constraints {
+
+class CompiledNetworkTest : public ::testing::Test
+{
+protected:
+  Network mNetwork;
+};
+
+TEST_F(CompiledNetworkTest, copiesValues)
+{
+  Wire& a = mNetwork.make(3);
+  Wire& b = mNetwork.make(4);
+  Wire& product = a * b;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_EQ(compiled.getWireCount(), 3u);
+  ASSERT_EQ(compiled.getOperationCount(), 1u);
+  ASSERT_EQ(compiled.get(compiled.indexOf(product)), 12);
+}
+
+TEST_F(CompiledNetworkTest, setPropagatesLikeNetwork)
+{
+  Wire& a = mNetwork.make(50);
+  Wire& b = mNetwork.make(35);
+  Wire& c = mNetwork.make(1);
+  Wire& sum = a + b * c;
+  sum <= 100;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(c), 1.25));
+  ASSERT_TRUE(c.set(1.25));
+  ASSERT_EQ(compiled.get(compiled.indexOf(sum)), sum.get());
+}
+
+TEST_F(CompiledNetworkTest, doesNotModifyNetwork)
+{
+  Wire& a = mNetwork.make(1);
+  Wire& sum = a + a;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), 5));
+  ASSERT_EQ(a.get(), 1);
+  ASSERT_EQ(sum.get(), 2);
+}
+
+TEST_F(CompiledNetworkTest, failureMessageMatchesNetwork)
+{
+  Wire& a = mNetwork.make(50);
+  Wire& b = mNetwork.make(35);
+  Wire& c = mNetwork.make(1);
+  Wire& upperLimit = mNetwork.make(100);
+  a + (b * c) <= upperLimit;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  Result compiledResult = compiled.set(compiled.indexOf(b), 51);
+  Result result = b.set(51);
+  ASSERT_FALSE(compiledResult);
+  ASSERT_EQ(compiledResult.getErrorMessage(), result.getErrorMessage());
+}
+
+TEST_F(CompiledNetworkTest, diamondsAreEvaluatedOnce)
+{
+  Wire& w = mNetwork.make(0);
+  Wire* last = &w;
+  for (int i = 0; i < 14; ++i)
+  {
+    last = &(*last + *last);
+  }
+  *last <= 10000;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(w), 0.5));
+  ASSERT_EQ(compiled.get(compiled.indexOf(*last)), 8192.0);
+  ASSERT_FALSE(compiled.set(compiled.indexOf(w), 1));
+}
+
+TEST_F(CompiledNetworkTest, verifyChecksAllRelations)
+{
+  Network network(false);
+  Wire& a = network.make(1);
+  a <= 0;
+
+  CompiledNetwork compiled = network.compile();
+  ASSERT_FALSE(compiled.verify());
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), -1));
+  ASSERT_TRUE(compiled.verify());
+}
+
+TEST_F(CompiledNetworkTest, batchMatchesSettingEachScenario)
+{
+  Wire& a = mNetwork.make("A", 0);
+  Wire& b = mNetwork.make("B", 0);
+  Wire& c = mNetwork.make("C", 2);
+  a + b <= 100;
+  a * c <= 50;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  std::vector<double> columnA;
+  std::vector<double> columnB;
+  for (int i = 0; i < 150; ++i)
+  {
+    columnA.push_back(i * 0.25);
+    // Every seventh scenario exceeds the limit of the sum
+    columnB.push_back(i % 7 == 0 ? 101 - i * 0.25 : 100 - i * 0.5);
+  }
+  const std::vector<CompiledNetwork::Index> inputs = {compiled.indexOf(a),
+                                                      compiled.indexOf(b)};
+  CompiledNetwork::BatchResult batch = compiled.evaluateBatch(
+    inputs, {columnA.data(), columnB.data()}, columnA.size());
+
+  for (std::size_t i = 0; i < columnA.size(); ++i)
+  {
+    const bool expected =
+      columnA[i] + columnB[i] <= 100 && columnA[i] * 2 <= 50;
+    ASSERT_EQ(batch.hasPassed(i), expected) << "Scenario " << i;
+    if (expected)
+    {
+      ASSERT_EQ(batch.firstFailure[i], CompiledNetwork::NONE);
+    }
+  }
+  ASSERT_EQ(compiled.getOperationName(batch.firstFailure[7]), "A + B <= 100");
+  ASSERT_EQ(compiled.getOperationName(batch.firstFailure[140]),
+            "A + B <= 100");
+  ASSERT_EQ(compiled.getOperationName(batch.firstFailure[141]),
+            "(A) * (C) <= 50");
+  ASSERT_EQ(compiled.get(compiled.indexOf(a)), 0);
+}
+
+TEST_F(CompiledNetworkTest, batchTreatsNaNLikeSet)
+{
+  Wire& a = mNetwork.make("A", 0);
+  Wire& b = mNetwork.make("B", 0);
+  min(a, b) <= 100;
+  max(a, b) <= 100;
+  clamp(a, -1, 1) <= 100;
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<double> values = {nan, -5, 0, -0.0, 5, 200};
+  std::vector<double> columnA;
+  std::vector<double> columnB;
+  for (auto valueA : values)
+  {
+    for (auto valueB : values)
+    {
+      columnA.push_back(valueA);
+      columnB.push_back(valueB);
+    }
+  }
+  CompiledNetwork compiled = mNetwork.compile();
+  const std::vector<CompiledNetwork::Index> inputs = {compiled.indexOf(a),
+                                                      compiled.indexOf(b)};
+  CompiledNetwork::BatchResult batch = compiled.evaluateBatch(
+    inputs, {columnA.data(), columnB.data()}, columnA.size());
+
+  for (std::size_t i = 0; i < columnA.size(); ++i)
+  {
+    compiled.set(inputs[0], columnA[i]);
+    compiled.set(inputs[1], columnB[i]);
+    const bool passed = compiled.verify();
+    ASSERT_EQ(batch.hasPassed(i), passed) << "Scenario " << i;
+    ASSERT_EQ(batch.hasPassed(i),
+              static_cast<bool>(mNetwork.setMany(
+                {{&a, columnA[i]}, {&b, columnB[i]}})))
+      << "Scenario " << i;
+  }
+  // A clamped NaN is not within any limit
+  ASSERT_FALSE(batch.hasPassed(0));
+}
+
+TEST_F(CompiledNetworkTest, emptyBatch)
+{
+  mNetwork.make(1) <= 2;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  CompiledNetwork::BatchResult batch = compiled.evaluateBatch({}, {}, 0);
+  ASSERT_TRUE(batch.passed.empty());
+  ASSERT_TRUE(batch.firstFailure.empty());
+}
+
+TEST_F(CompiledNetworkTest, parallelSetMatchesSequentialSet)
+{
+  // Wide levels of independent sums, so that levels are split into chunks
+  Wire& parameter = mNetwork.make("Parameter", 1);
+  std::vector<Wire*> level;
+  for (int i = 0; i < 2000; ++i)
+  {
+    level.push_back(&(parameter + mNetwork.make(i)));
+  }
+  for (int depth = 0; depth < 3; ++depth)
+  {
+    for (std::size_t i = 0; i < level.size(); ++i)
+    {
+      level[i] = &(*level[i] + *level[(i + 1) % level.size()]);
+    }
+  }
+  for (auto wire : level)
+  {
+    *wire <= 100000;
+  }
+
+  CompiledNetwork sequential = mNetwork.compile();
+  CompiledNetwork parallel = mNetwork.compile();
+  ThreadPool pool(4);
+  const CompiledNetwork::Index index = sequential.indexOf(parameter);
+  for (double value : {2.0, -50.0, 10000.0, 3.0})
+  {
+    Result expected = sequential.set(index, value);
+    Result actual = parallel.set(index, value, pool);
+    ASSERT_EQ(bool(actual), bool(expected));
+    if (!expected)
+    {
+      ASSERT_EQ(actual.getErrorMessage(), expected.getErrorMessage());
+    }
+  }
+  for (auto wire : level)
+  {
+    const CompiledNetwork::Index i = sequential.indexOf(*wire);
+    ASSERT_EQ(parallel.get(i), sequential.get(i));
+  }
+}
+
+TEST_F(CompiledNetworkTest, parallelSetStopsWhereSequentialSetStops)
+{
+  // One wide level mixing relations and sums, with a single failing
+  // relation in the middle of the tape
+  Wire& parameter = mNetwork.make("Parameter", 1);
+  std::vector<Wire*> wires;
+  for (int i = 0; i < 2000; ++i)
+  {
+    wires.push_back(&(parameter + mNetwork.make(i)));
+  }
+  for (std::size_t i = 0; i < 2000; ++i)
+  {
+    *wires[i] <= (i == 1000 ? 5000 : 100000);
+    wires.push_back(&(*wires[i] + *wires[(i + 1) % 2000]));
+  }
+
+  CompiledNetwork sequential = mNetwork.compile();
+  CompiledNetwork parallel = mNetwork.compile();
+  ThreadPool pool(4);
+  const CompiledNetwork::Index index = sequential.indexOf(parameter);
+  Result expected = sequential.set(index, 4500);
+  Result actual = parallel.set(index, 4500, pool);
+  ASSERT_FALSE(expected);
+  ASSERT_FALSE(actual);
+  ASSERT_EQ(actual.getErrorMessage(), expected.getErrorMessage());
+  for (auto wire : wires)
+  {
+    const CompiledNetwork::Index i = sequential.indexOf(*wire);
+    ASSERT_EQ(parallel.get(i), sequential.get(i));
+  }
+}
+
+TEST_F(CompiledNetworkTest, parallelSetOfDrivenWireStartsTheCause)
+{
+  Wire& sum = mNetwork.make("A", 1) + mNetwork.make("B", 2);
+  sum <= 5;
+  sum + mNetwork.make("C", 0) <= 4;
+
+  CompiledNetwork sequential = mNetwork.compile();
+  CompiledNetwork parallel = mNetwork.compile();
+  ThreadPool pool(2);
+  const CompiledNetwork::Index index = sequential.indexOf(sum);
+  Result expected = sequential.set(index, 10);
+  Result actual = parallel.set(index, 10, pool);
+  ASSERT_FALSE(expected);
+  ASSERT_FALSE(actual);
+  ASSERT_EQ(actual.getErrorMessage(), expected.getErrorMessage());
+}
+
+}}
@@ -0,0 +1,93 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Equal.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class EqualTest : public ::testing::Test
+{
+public:
+  Range range(Equal& equal, Wire& wire) { return equal.range(wire); }
+
+protected:
+  Network mNetwork;
+};
+
+TEST_F(EqualTest, equalValues)
+{
+  Wire& a = mNetwork.make(3);
+  Wire& b = mNetwork.make(3);
+
+  // No assertion should fail
+  a.equals(b);
+  a.equals(3);
+}
+
+TEST_F(EqualTest, differentValues)
+{
+  Wire& a = mNetwork.make(3);
+  Wire& b = mNetwork.make(4);
+  ASSERT_DEATH(a.equals(b), ".*");
+}
+
+TEST_F(EqualTest, tolerance)
+{
+  Wire& a = mNetwork.make(3);
+  Wire& b = mNetwork.make(3.5);
+  a.equals(b, 0.5);
+  ASSERT_TRUE(a.set(4));
+  ASSERT_FALSE(a.set(4.25));
+  ASSERT_TRUE(b.set(4.5));
+  ASSERT_FALSE(b.set(3.5));
+}
+
+TEST_F(EqualTest, rangeOfBothWires)
+{
+  Wire& a = mNetwork.make(3);
+  Wire& b = mNetwork.make(4);
+  Equal& equal = a.equals(b, 1);
+  ASSERT_EQ(range(equal, a), Range(3, 5));
+  ASSERT_EQ(range(equal, b), Range(2, 4));
+}
+
+TEST_F(EqualTest, rangeThroughSum)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  (a + b).equals(3);
+  ASSERT_EQ(a.range(), Range(1, 1));
+  ASSERT_EQ(mNetwork.computeAllRanges()[&b], Range(2, 2));
+}
+
+TEST_F(EqualTest, name)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 3);
+  ASSERT_EQ(a.equals(b).getName(), "A == B");
+  ASSERT_EQ(a.equals(b, 0.5).getName(), "A == B within 0.5");
+  ASSERT_EQ(a.set(4).getErrorMessage(), "A == B would fail.");
+}
+
+TEST_F(EqualTest, compiled)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 3);
+  a.equals(b, 1);
+  CompiledNetwork compiled = mNetwork.compile();
+  const CompiledNetwork::Index index = compiled.indexOf(a);
+  ASSERT_TRUE(compiled.set(index, 2));
+  ASSERT_FALSE(compiled.set(index, 4.5));
+
+  const double values[] = {1.5, 2, 4, 4.5};
+  CompiledNetwork::BatchResult batch =
+    compiled.evaluateBatch({index}, {values}, 4);
+  ASSERT_FALSE(batch.hasPassed(0));
+  ASSERT_TRUE(batch.hasPassed(1));
+  ASSERT_TRUE(batch.hasPassed(2));
+  ASSERT_FALSE(batch.hasPassed(3));
+}
+
+}}
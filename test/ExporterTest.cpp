@@ -0,0 +1,203 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Exporter.h"
+
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+namespace common { namespace constraints {
+
+class ExporterTest : public ::testing::Test
+{
+protected:
+  ExporterTest()
+    : mA(mNetwork.make("A", 4))
+    , mB(mNetwork.make("B", 5))
+    , mProduct(mA * mB)
+  {
+    mProduct <= 30;
+  }
+
+  Network mNetwork;
+  Wire& mA;
+  Wire& mB;
+  Wire& mProduct;
+};
+
+TEST_F(ExporterTest, textMatchesDump)
+{
+  std::ostringstream s;
+  Exporter(mA).write(s, Exporter::TEXT);
+  ASSERT_EQ(s.str(), mA.dump());
+  ASSERT_EQ(s.str(),
+            "A with value 4 and range [-inf, 6]\n"
+            "  (A)=4 * (B)=5\n"
+            "    (A) * (B) with value 20 and range [-inf, 30]\n"
+            "      ((A) * (B))=20 <= (30)=30\n");
+}
+
+TEST_F(ExporterTest, textDescribesLiteralsLikeConstantWires)
+{
+  Wire& c = mNetwork.make("C", 2);
+  c * -1 + 3 <= 5;
+  ASSERT_EQ(c.dump(),
+            "C with value 2 and range [-2, inf]\n"
+            "  (C)=2 * (-1)=-1\n"
+            "    (C) * (-1) with value -2 and range [-inf, 2]\n"
+            "      ((C) * (-1))=-2 + (3)=3\n"
+            "        (C) * (-1) + 3 with value 1 and range [-inf, 5]\n"
+            "          ((C) * (-1) + 3)=1 <= (5)=5\n");
+}
+
+TEST_F(ExporterTest, textWritesRepeatedInputOnce)
+{
+  // The sum has one input with the coefficient two, unlike a product of a
+  // wire with itself, which reads it twice
+  Wire& c = mNetwork.make("C", 2);
+  c + c;
+  ASSERT_EQ(c.dump(),
+            "C with value 2 and range [-inf, inf]\n"
+            "  (C)=2 + (C)=2\n"
+            "    C + C with value 4 and range [-inf, inf]\n");
+}
+
+TEST_F(ExporterTest, textOnlyRangesWiresItWrites)
+{
+  // X reaches both factors of the product, so its range cannot be solved,
+  // but the dump of Z does not show it
+  Wire& x = mNetwork.make("X", 1);
+  Wire& y = mNetwork.make("Y", 1);
+  Wire& z = mNetwork.make("Z", 5);
+  Wire& sum = x + y;
+  sum * (sum + 1) * 1 <= z + x + x;
+  ASSERT_EQ(z.dump(),
+            "Z with value 5 and range [4, inf]\n"
+            "  (Z)=5 + (X)=1\n"
+            "    Z + X with value 6 and range [5, inf]\n"
+            "      (Z + X)=6 + (X)=1\n"
+            "        Z + X + X with value 7 and range [6, inf]\n"
+            "          (((X + Y) * (X + Y + 1)) * (1))=6 <= (Z + X + X)=7\n");
+}
+
+TEST_F(ExporterTest, nonlinearRangeIsReported)
+{
+  Wire& x = mNetwork.make("X", 1);
+  x * x <= 4;
+  ASSERT_EQ(x.dump(),
+            "X with value 1 and range nonlinear\n"
+            "  (X)=1 * (X)=1\n"
+            "    (X) * (X) with value 1 and range [-inf, 4]\n"
+            "      ((X) * (X))=1 <= (4)=4\n"
+            "  (X)=1 * (X)=1\n"
+            "    (X) * (X) with value 1 and range [-inf, 4]\n"
+            "      ((X) * (X))=1 <= (4)=4\n");
+
+  Exporter exporter(mNetwork);
+  ASSERT_FALSE(exporter.isSolved(x));
+  ASSERT_TRUE(exporter.isSolved(mA));
+  std::ostringstream s;
+  exporter.write(s, Exporter::JSON);
+  ASSERT_NE(s.str().find("\"range\":null,\"nonlinear\":true"),
+            std::string::npos);
+}
+
+TEST_F(ExporterTest, textOfNetworkHasTreePerInput)
+{
+  std::ostringstream s;
+  Exporter(mNetwork).write(s, Exporter::TEXT);
+  ASSERT_EQ(s.str(), mA.dump() + mB.dump());
+}
+
+TEST_F(ExporterTest, rangesAreComputedOnce)
+{
+  Exporter exporter(mNetwork);
+  ASSERT_EQ(exporter.getRange(mA), mA.range());
+  ASSERT_EQ(exporter.getRange(mProduct), mProduct.range());
+
+  // The exporter keeps the ranges from when it was created
+  ASSERT_TRUE(mB.set(2));
+  ASSERT_NE(exporter.getRange(mA), mA.range());
+}
+
+TEST_F(ExporterTest, wireExportKeepsRangesOfInputs)
+{
+  // Limits B through a relation that is not downstream of A
+  Wire& c = mNetwork.make("C", 1);
+  mB <= c + 5;
+  Exporter exporter(mA);
+  ASSERT_EQ(exporter.getRange(mB), Range(Range::NEGATIVE_INFINITY, 6));
+  ASSERT_EQ(exporter.getRange(mB), mB.range());
+  ASSERT_EQ(exporter.getRange(mProduct), mProduct.range());
+}
+
+TEST_F(ExporterTest, dot)
+{
+  std::ostringstream s;
+  Exporter(mNetwork).write(s, Exporter::DOT);
+  ASSERT_EQ(s.str(),
+            "digraph Network {\n"
+            "  w0 [shape=box, label=\"A\\n4\\n[-inf, 6]\"];\n"
+            "  w1 [shape=box, label=\"B\\n5\\n[-inf, 7.5]\"];\n"
+            "  w2 [shape=box, label=\"\\n20\\n[-inf, 30]\"];\n"
+            "  w3 [shape=box, label=\"30\\n30\\n[20, inf]\"];\n"
+            "  o0 [shape=circle, label=\"*\"];\n"
+            "  w0 -> o0;\n"
+            "  w1 -> o0;\n"
+            "  o0 -> w2;\n"
+            "  o1 [shape=circle, label=\"<=\"];\n"
+            "  w2 -> o1;\n"
+            "  w3 -> o1;\n"
+            "}\n");
+}
+
+TEST_F(ExporterTest, json)
+{
+  std::ostringstream s;
+  Exporter(mNetwork).write(s, Exporter::JSON);
+  ASSERT_EQ(s.str(),
+            "{\"wires\":["
+            "{\"id\":0,\"name\":\"A\",\"value\":4,\"range\":[null,6],"
+            "\"constant\":false},"
+            "{\"id\":1,\"name\":\"B\",\"value\":5,\"range\":[null,7.5],"
+            "\"constant\":false},"
+            "{\"id\":2,\"name\":null,\"value\":20,\"range\":[null,30],"
+            "\"constant\":false},"
+            "{\"id\":3,\"name\":\"30\",\"value\":30,\"range\":[20,null],"
+            "\"constant\":true}],"
+            "\"operations\":["
+            "{\"id\":0,\"kind\":\"multiply\",\"inputs\":[0,1],\"output\":2},"
+            "{\"id\":1,\"kind\":\"lessOrEqual\",\"inputs\":[2,3],"
+            "\"output\":null}]}\n");
+}
+
+TEST_F(ExporterTest, longSumExportsInLinearSize)
+{
+  const int count = 1000;
+  Wire* sum = &mNetwork.make("S", 0);
+  for (int i = 0; i < count; ++i)
+  {
+    sum = &(*sum + mNetwork.make(1));
+  }
+  std::ostringstream s;
+  Exporter(mNetwork).write(s, Exporter::JSON);
+  // Each intermediate sum refers to the previous one instead of repeating
+  // all of its terms
+  ASSERT_LT(s.str().size(), 300u * count);
+}
+
+TEST_F(ExporterTest, wireExportsOnlyDownstreamOperations)
+{
+  Wire& c = mNetwork.make("C", 1);
+  c <= 2;
+  std::ostringstream s;
+  Exporter(c).write(s, Exporter::JSON);
+  ASSERT_EQ(s.str().find("\"A\""), std::string::npos);
+  ASSERT_NE(s.str().find("\"C\""), std::string::npos);
+  ASSERT_EQ(s.str().find("multiply"), std::string::npos);
+}
+
+}}
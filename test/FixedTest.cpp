@@ -0,0 +1,83 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Fixed.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+TEST(FixedTest, convertsFromAndToDouble)
+{
+  ASSERT_EQ(static_cast<double>(Fixed(1.5)), 1.5);
+  ASSERT_EQ(static_cast<double>(Fixed(-2.25)), -2.25);
+  ASSERT_EQ(Fixed(1.0).getRaw(), 1 << Fixed::FRACTIONAL_BITS);
+  ASSERT_EQ(Fixed(0.1).getRaw(), 6554);
+}
+
+TEST(FixedTest, conversionSaturates)
+{
+  ASSERT_EQ(Fixed(1e9), std::numeric_limits<Fixed>::max());
+  ASSERT_EQ(Fixed(-1e9), std::numeric_limits<Fixed>::lowest());
+  ASSERT_EQ(Fixed(std::numeric_limits<double>::quiet_NaN()), Fixed());
+}
+
+TEST(FixedTest, arithmetic)
+{
+  ASSERT_EQ(Fixed(1.5) + Fixed(2.25), Fixed(3.75));
+  ASSERT_EQ(Fixed(1.5) - Fixed(2.25), Fixed(-0.75));
+  ASSERT_EQ(Fixed(1.5) * Fixed(-2.5), Fixed(-3.75));
+  ASSERT_EQ(Fixed(7.5) / Fixed(2.5), Fixed(3));
+  ASSERT_EQ(-Fixed(4), Fixed(-4));
+}
+
+TEST(FixedTest, arithmeticSaturates)
+{
+  const Fixed max = std::numeric_limits<Fixed>::max();
+  const Fixed lowest = std::numeric_limits<Fixed>::lowest();
+  ASSERT_EQ(max + Fixed(1), max);
+  ASSERT_EQ(lowest - Fixed(1), lowest);
+  ASSERT_EQ(Fixed(30000) * Fixed(2), max);
+  ASSERT_EQ(Fixed(30000) * Fixed(-2), lowest);
+  ASSERT_EQ(-lowest, max);
+  ASSERT_EQ(Fixed(1) / Fixed(0), max);
+  ASSERT_EQ(Fixed(-1) / Fixed(0), lowest);
+  ASSERT_EQ(Fixed(0) / Fixed(0), Fixed(0));
+}
+
+TEST(FixedTest, largestAndLowestValuesStayInfinite)
+{
+  const Fixed max = std::numeric_limits<Fixed>::max();
+  const Fixed lowest = std::numeric_limits<Fixed>::lowest();
+  ASSERT_EQ(-max, lowest);
+  ASSERT_EQ(max - Fixed(4), max);
+  ASSERT_EQ(lowest + Fixed(47), lowest);
+  ASSERT_EQ(max + lowest, Fixed());
+  ASSERT_EQ(max * Fixed(-0.5), lowest);
+  ASSERT_EQ(max * Fixed(), Fixed());
+  ASSERT_EQ(lowest / Fixed(-4), max);
+  ASSERT_EQ(Fixed(4) / max, Fixed());
+  ASSERT_EQ(static_cast<double>(max),
+            std::numeric_limits<double>::infinity());
+  ASSERT_EQ(static_cast<double>(lowest),
+            -std::numeric_limits<double>::infinity());
+  ASSERT_EQ(Fixed(-std::numeric_limits<double>::infinity()), lowest);
+}
+
+TEST(FixedTest, productIsRoundedToNearest)
+{
+  const Fixed step = Fixed::fromRaw(1);
+  ASSERT_EQ(step * Fixed(0.5), step);
+  ASSERT_EQ(step * Fixed(0.25), Fixed());
+  ASSERT_EQ(-step * Fixed(0.5), -step);
+}
+
+TEST(FixedTest, comparison)
+{
+  ASSERT_TRUE(Fixed(1) < Fixed(2));
+  ASSERT_TRUE(Fixed(2) <= Fixed(2));
+  ASSERT_TRUE(Fixed(-1) > Fixed(-2));
+  ASSERT_TRUE(Fixed(2) >= Fixed(2));
+  ASSERT_TRUE(Fixed(2) != Fixed(3));
+}
+
+}}
@@ -3,6 +3,7 @@
 #include "LessOrEqual.h"
 #include "Network.h"
 #include "commonconstraintsMockWire.h"
+#include "commonconstraintsTolerance.h"
 
 #include <gtest/gtest.h>
 
@@ -17,6 +18,10 @@ class LessOrEqualTest : public ::testing::Test
 {
 public:
   Range range(LessOrEqual& le, Wire& wire) { return le.range(wire); }
+  Range solve(WireExpression left, WireExpression right)
+  {
+    return LessOrEqual::solveInequality(left, right);
+  }
   IWire& leftWire(LessOrEqual& le) { return le.mLeft; }
   IWire& rightWire(LessOrEqual& le) { return le.mRight; }
 
@@ -153,4 +158,25 @@ TEST_F(LessOrEqualTest, rangeOfFactorIsScaled)
   ASSERT_EQ(coefficient.range(), Range::FULL);
 }
 
+TEST_F(LessOrEqualTest, solveInequalityIsPreciseInValueType)
+{
+  // 3x + 0.1 <= 1.1 is equivalent to x <= 1/3
+  const Range upper = solve(WireExpression::createLinear(3, 0.1),
+                            WireExpression::createLinear(0, 1.1));
+  ASSERT_EQ(upper.lower, Range::NEGATIVE_INFINITY);
+  ASSERT_NEAR(static_cast<double>(upper.upper), 1.0 / 3, TOLERANCE);
+
+  // 0.7 <= -0.2x + 0.3 is equivalent to x <= -2
+  const Range lower = solve(WireExpression::createLinear(0, 0.7),
+                            WireExpression::createLinear(-0.2, 0.3));
+  ASSERT_EQ(lower.lower, Range::NEGATIVE_INFINITY);
+  ASSERT_NEAR(static_cast<double>(lower.upper), -2, TOLERANCE);
+
+  // 0.7 <= 0.2x + 0.3 is equivalent to x >= 2
+  const Range both = solve(WireExpression::createLinear(0, 0.7),
+                           WireExpression::createLinear(0.2, 0.3));
+  ASSERT_NEAR(static_cast<double>(both.lower), 2, TOLERANCE);
+  ASSERT_EQ(both.upper, Range::POSITIVE_INFINITY);
+}
+
 }}
@@ -0,0 +1,276 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "LinearCombination.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+#include "Wire.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace common { namespace constraints {
+
+class LinearCombinationTest : public ::testing::Test
+{
+protected:
+  const LinearCombination& getCombination(const Wire& wire)
+  {
+    return *wire.mCombination;
+  }
+
+  std::size_t countInputs(const Wire& wire)
+  {
+    return getCombination(wire).mInputs.size();
+  }
+
+  bool isDetached(const Wire& wire) { return wire.mDetached; }
+
+protected:
+  Network mNetwork;
+};
+
+TEST_F(LinearCombinationTest, weightedSum)
+{
+  Wire& a = mNetwork.make("A", 2);
+  Wire& b = mNetwork.make("B", 3);
+  Wire& sum = mNetwork.linearCombination({{&a, 4}, {&b, -1}}, 10);
+  ASSERT_EQ(sum.get(), 15);
+  ASSERT_TRUE(a.set(1));
+  ASSERT_EQ(sum.get(), 11);
+  ASSERT_EQ(sum.getName(), "(A) * (4) + (B) * (-1) + 10");
+}
+
+TEST_F(LinearCombinationTest, constantsAreFolded)
+{
+  Wire& a = mNetwork.make("A", 2);
+  Wire& sum = mNetwork.linearCombination(
+    {{&a, 1}, {&mNetwork.constant(3), 2}, {&a, 1}}, 1);
+  ASSERT_EQ(sum.get(), 11);
+  ASSERT_EQ(countInputs(sum), 1u);
+  ASSERT_TRUE(mNetwork.linearCombination({{&mNetwork.constant(3), 2}})
+                .isConstant());
+}
+
+TEST_F(LinearCombinationTest, longSumIsOneOperation)
+{
+  std::vector<Wire*> inputs;
+  std::vector<std::pair<Wire*, Value>> terms;
+  for (int i = 0; i < 100; ++i)
+  {
+    inputs.push_back(&mNetwork.make(i));
+    terms.emplace_back(inputs.back(), 1);
+  }
+  Wire& sum = mNetwork.linearCombination(terms);
+  ASSERT_EQ(sum.get(), 4950);
+  ASSERT_EQ(countInputs(sum), 100u);
+
+  // Only the one operation is evaluated per change
+  mNetwork.resetStats();
+  ASSERT_TRUE(inputs[50]->set(0));
+  ASSERT_EQ(sum.get(), 4900);
+#ifdef CONSTRAINTS_ENABLE_STATS
+  ASSERT_EQ(mNetwork.stats().operationsEvaluated, 1u);
+#endif
+}
+
+TEST_F(LinearCombinationTest, scalingAndOffsets)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& result = ((a + b) * 2 - 1) / 4 + a;
+  ASSERT_EQ(result.get(), 2.25);
+  ASSERT_TRUE(a.set(3));
+  ASSERT_EQ(result.get(), 5.25);
+}
+
+TEST_F(LinearCombinationTest, intermediateWireStaysInTheNetwork)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& c = mNetwork.make("C", 3);
+  Wire& partial = a + b;
+  Wire& total = partial + c;
+  total <= 10;
+  ASSERT_FALSE(isDetached(partial));
+  ASSERT_EQ(partial.getName(), "A + B");
+  ASSERT_EQ(total.getName(), "A + B + C");
+
+  ASSERT_EQ(partial.range(), Range(Range::NEGATIVE_INFINITY, 7));
+  ASSERT_NE(partial.dump().find("<= (10)=10"), std::string::npos);
+  ASSERT_FALSE(partial.set(100));
+  ASSERT_TRUE(partial.set(5));
+  ASSERT_EQ(total.get(), 8);
+  ASSERT_TRUE(a.set(5));
+  ASSERT_EQ(partial.get(), 7);
+  ASSERT_EQ(total.get(), 10);
+}
+
+TEST_F(LinearCombinationTest, intermediateWireUsedTwiceKeepsItsRange)
+{
+  Wire& x = mNetwork.make("X", 0);
+  Wire& limit = mNetwork.make("Limit", 10);
+  Wire& partial = x + 2;
+  Wire& total = partial + 0;
+  total <= limit;
+  total <= partial;
+  ASSERT_EQ(partial.range(), Range(Range::NEGATIVE_INFINITY, 10));
+  ASSERT_EQ(x.range(), Range(Range::NEGATIVE_INFINITY, 8));
+}
+
+TEST_F(LinearCombinationTest, mergedWireIsEvaluatedOnDemand)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& c = mNetwork.make("C", 3);
+  Wire& partial = a + b;
+  Wire& total = partial + c;
+  total <= 100;
+  mNetwork.optimize();
+  ASSERT_TRUE(isDetached(partial));
+  ASSERT_EQ(countInputs(total), 3u);
+  ASSERT_TRUE(a.set(5));
+  ASSERT_EQ(partial.get(), 7);
+  ASSERT_EQ(total.get(), 10);
+  ASSERT_EQ(total.getName(), "A + B + C");
+}
+
+TEST_F(LinearCombinationTest, usingMergedWireReconnectsIt)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& c = mNetwork.make("C", 3);
+  Wire& partial = a + b;
+  Wire& total = partial + c;
+  total <= 100;
+  mNetwork.optimize();
+  partial <= 10;
+  ASSERT_FALSE(isDetached(partial));
+  ASSERT_EQ(total.get(), 6);
+
+  ASSERT_TRUE(b.set(4));
+  ASSERT_EQ(partial.get(), 5);
+  ASSERT_EQ(total.get(), 8);
+  ASSERT_FALSE(b.set(10));
+  ASSERT_EQ(partial.range(), Range(Range::FULL.lower, 10));
+  ASSERT_EQ(b.range(), Range(Range::FULL.lower, 9));
+}
+
+TEST_F(LinearCombinationTest, checkDoesNotChangeTheSum)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& sum = a * 3 + b;
+  sum <= 10;
+  ASSERT_TRUE(a.check(2));
+  ASSERT_FALSE(a.check(4));
+  ASSERT_EQ(sum.get(), 5);
+  ASSERT_TRUE(b.set(4));
+  ASSERT_EQ(sum.get(), 7);
+}
+
+TEST_F(LinearCombinationTest, failedTransactionIsUndone)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& sum = a + b;
+  sum <= 10;
+  ASSERT_FALSE(mNetwork.setMany({{&a, 5}, {&b, 6}}));
+  ASSERT_EQ(sum.get(), 3);
+
+  // The sum does not keep the values that were undone
+  ASSERT_TRUE(a.set(2));
+  ASSERT_EQ(sum.get(), 4);
+}
+
+TEST_F(LinearCombinationTest, missedUpdateIsRecomputed)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& product = a * b;
+  Wire& sum = product * a + b;
+  // Fails before the sum, which has a higher rank, is evaluated
+  product <= 10;
+  ASSERT_FALSE(b.set(20));
+  ASSERT_EQ(sum.get(), 4);
+
+  // Only the product changes now, but the change of B must not be lost
+  ASSERT_TRUE(a.set(0.5));
+  ASSERT_EQ(sum.get(), 25);
+}
+
+TEST_F(LinearCombinationTest, infiniteInputIsTakenOutAgain)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& sum = a + b;
+  ASSERT_TRUE(a.set(std::numeric_limits<Value>::infinity()));
+  ASSERT_TRUE(a.set(1));
+  ASSERT_EQ(sum.get(), 3);
+}
+
+TEST_F(LinearCombinationTest, smallInputIsNotLostNextToLargeOne)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 0);
+  Wire& sum = a + b;
+  sum <= 10;
+  ASSERT_FALSE(b.set(1e17));
+  ASSERT_TRUE(b.set(0));
+  ASSERT_EQ(sum.get(), 1);
+  ASSERT_FALSE(a.set(10.5));
+  ASSERT_EQ(sum.get(), 10.5);
+}
+
+TEST_F(LinearCombinationTest, expression)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& sum = (a + b) * 2 + a + 3;
+  const WireExpression expression = sum.expression(a);
+  ASSERT_EQ(expression.firstDegree, 3);
+  ASSERT_EQ(expression.constant, 7);
+}
+
+TEST_F(LinearCombinationTest, compiledNetworkMatches)
+{
+  Wire& a = mNetwork.make("A", 1);
+  Wire& b = mNetwork.make("B", 2);
+  Wire& partial = a + b * 2;
+  Wire& total = partial + a * -1 + 5;
+  total <= 20;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(b), 4));
+  ASSERT_TRUE(b.set(4));
+  ASSERT_EQ(compiled.get(compiled.indexOf(total)), total.get());
+  ASSERT_EQ(compiled.get(compiled.indexOf(partial)), partial.get());
+  ASSERT_FALSE(compiled.set(compiled.indexOf(b), 20));
+}
+
+TEST_F(LinearCombinationTest, compiledIntermediateWiresFollowTheirInputs)
+{
+  Wire& a = mNetwork.make("A", 1);
+  std::vector<Wire*> partials{&a};
+  for (int i = 1; i < 10; ++i)
+  {
+    partials.push_back(&(*partials.back() * 2 + mNetwork.make(i)));
+  }
+  *partials.back() <= 1e9;
+  mNetwork.optimize();
+  for (std::size_t i = 1; i + 1 < partials.size(); ++i)
+  {
+    ASSERT_TRUE(isDetached(*partials[i]));
+  }
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), 3));
+  ASSERT_TRUE(a.set(3));
+  for (auto partial : partials)
+  {
+    ASSERT_EQ(compiled.get(compiled.indexOf(*partial)), partial->get());
+  }
+}
+
+}}
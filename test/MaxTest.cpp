@@ -0,0 +1,87 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Max.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class MaxTest : public ::testing::Test
+{
+protected:
+  Network mNetwork;
+};
+
+TEST_F(MaxTest, valueIsTheLargerInput)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  Wire& larger = max(a, b);
+  ASSERT_EQ(larger.get(), 5);
+  ASSERT_TRUE(a.set(7));
+  ASSERT_EQ(larger.get(), 7);
+  ASSERT_EQ(larger.getName(), "max(A, B)");
+}
+
+TEST_F(MaxTest, literalsAndConstants)
+{
+  Wire& a = mNetwork.make("A", 3);
+  ASSERT_EQ(max(a, 1).get(), 3);
+  ASSERT_EQ(max(10, a).get(), 10);
+  ASSERT_TRUE(max(mNetwork.constant(2), mNetwork.constant(4)).isConstant());
+}
+
+TEST_F(MaxTest, largerLoadStaysUnderLimit)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  max(a, b) <= 10;
+  ASSERT_TRUE(a.set(10));
+  ASSERT_TRUE(b.set(-20));
+  ASSERT_FALSE(b.set(11));
+  ASSERT_FALSE(a.set(11));
+}
+
+TEST_F(MaxTest, rangeFollowsTheActiveInput)
+{
+  Wire& a = mNetwork.make("A", 4);
+  Wire& b = mNetwork.make("B", 7);
+  max(a, b + 1) <= 10;
+  // Each range is limited to where the larger input stays the larger
+  ASSERT_EQ(b.range(), Range(3, 9));
+  ASSERT_EQ(a.range(), Range(Range::NEGATIVE_INFINITY, 8));
+
+  ASSERT_TRUE(a.set(9));
+  ASSERT_EQ(a.range(), Range(8, 10));
+  ASSERT_EQ(b.range(), Range(Range::NEGATIVE_INFINITY, 8));
+
+  auto ranges = mNetwork.computeAllRanges();
+  ASSERT_EQ(ranges[&a], a.range());
+  ASSERT_EQ(ranges[&b], b.range());
+}
+
+TEST_F(MaxTest, rangeOfTheSmallerInputExcludesViolations)
+{
+  Wire& a = mNetwork.make("A", 5);
+  Wire& b = mNetwork.make("B", 3);
+  max(a, b) <= 10;
+  ASSERT_EQ(b.range(), Range(Range::NEGATIVE_INFINITY, 5));
+  ASSERT_FALSE(b.set(11));
+}
+
+TEST_F(MaxTest, compiledNetworkMatches)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  Wire& larger = max(a, b);
+  larger <= 6;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(b), 1));
+  ASSERT_EQ(compiled.get(compiled.indexOf(larger)), 3);
+  ASSERT_FALSE(compiled.set(compiled.indexOf(a), 7));
+}
+
+}}
@@ -0,0 +1,79 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Min.h"
+#include "LessOrEqual.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class MinTest : public ::testing::Test
+{
+protected:
+  Network mNetwork;
+};
+
+TEST_F(MinTest, valueIsTheSmallerInput)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  Wire& smaller = min(a, b);
+  ASSERT_EQ(smaller.get(), 3);
+  ASSERT_TRUE(a.set(7));
+  ASSERT_EQ(smaller.get(), 5);
+  ASSERT_EQ(smaller.getName(), "min(A, B)");
+}
+
+TEST_F(MinTest, literalsAndConstants)
+{
+  Wire& a = mNetwork.make("A", 3);
+  ASSERT_EQ(min(a, 1).get(), 1);
+  ASSERT_EQ(min(10, a).get(), 3);
+  ASSERT_TRUE(min(mNetwork.constant(2), mNetwork.constant(4)).isConstant());
+}
+
+TEST_F(MinTest, relationOnMinimum)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  min(a, b) >= 2;
+  ASSERT_TRUE(b.set(2));
+  ASSERT_TRUE(a.set(10));
+  ASSERT_FALSE(b.set(1));
+  ASSERT_FALSE(a.set(1));
+}
+
+TEST_F(MinTest, rangeFollowsTheActiveInput)
+{
+  Wire& a = mNetwork.make("A", 2);
+  Wire& b = mNetwork.make("B", 5);
+  Wire& smaller = min(a * 2, b);
+  smaller >= 2;
+  // Each range is limited to where the smaller input stays the smaller
+  ASSERT_EQ(a.range(), Range(1, 2.5));
+  ASSERT_EQ(b.range(), Range(4, Range::POSITIVE_INFINITY));
+
+  ASSERT_TRUE(a.set(4));
+  ASSERT_EQ(a.range(), Range(2.5, Range::POSITIVE_INFINITY));
+  ASSERT_EQ(b.range(), Range(2, 8));
+
+  auto ranges = mNetwork.computeAllRanges();
+  ASSERT_EQ(ranges[&a], a.range());
+  ASSERT_EQ(ranges[&b], b.range());
+}
+
+TEST_F(MinTest, compiledNetworkMatches)
+{
+  Wire& a = mNetwork.make("A", 3);
+  Wire& b = mNetwork.make("B", 5);
+  Wire& smaller = min(a, b);
+  smaller >= 2;
+
+  CompiledNetwork compiled = mNetwork.compile();
+  ASSERT_TRUE(compiled.set(compiled.indexOf(a), 6));
+  ASSERT_EQ(compiled.get(compiled.indexOf(smaller)), 5);
+  ASSERT_FALSE(compiled.set(compiled.indexOf(b), 1));
+}
+
+}}
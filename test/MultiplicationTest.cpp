@@ -5,6 +5,7 @@
 #include "Wire.h"
 
 #include "commonconstraintsMockWire.h"
+#include "commonconstraintsTolerance.h"
 
 #include <gtest/gtest.h>
 
@@ -42,7 +43,7 @@ TEST_F(MultiplicationTest, twoTimesTwoEqualsFour)
 TEST_F(MultiplicationTest, multiplyNegativeFraction)
 {
   Wire& product = mNetwork.multiply(mNetwork.make(10), mNetwork.make(-0.1));
-  ASSERT_NEAR(product.get(), -1.0, 1e-7);
+  ASSERT_NEAR(static_cast<double>(product.get()), -1.0, TOLERANCE);
 }
 
 TEST_F(MultiplicationTest, mutliplyThreeWires)
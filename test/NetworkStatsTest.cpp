@@ -0,0 +1,93 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Network.h"
+
+#include "LessOrEqual.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+class NetworkStatsTest : public ::testing::Test
+{
+protected:
+  NetworkStatsTest()
+    : mInput(mNetwork.make("Input", 1))
+  {
+    // Input feeds a sum, which is limited by two relations
+    Wire& sum = mInput + mNetwork.make("Offset", 1);
+    sum <= 10;
+    mInput <= 20;
+    mNetwork.resetStats();
+  }
+
+  Network mNetwork;
+  Wire& mInput;
+};
+
+#if defined(CONSTRAINTS_ENABLE_STATS)
+
+TEST_F(NetworkStatsTest, countsPropagationWork)
+{
+  ASSERT_TRUE(mInput.set(2));
+  NetworkStats stats = mNetwork.stats();
+  EXPECT_EQ(stats.propagations, 1u);
+  EXPECT_EQ(stats.operationsEvaluated, 3u);
+  EXPECT_EQ(stats.wiresWritten, 2u);
+  EXPECT_EQ(stats.relationsChecked, 2u);
+  EXPECT_EQ(stats.relationsFailed, 0u);
+
+  ASSERT_FALSE(mInput.set(15));
+  stats = mNetwork.stats();
+  EXPECT_EQ(stats.propagations, 2u);
+  EXPECT_EQ(stats.relationsFailed, 1u);
+  EXPECT_EQ(stats.resultAllocations, 0u);
+}
+
+TEST_F(NetworkStatsTest, countsQueryWork)
+{
+  mInput.range();
+  NetworkStats stats = mNetwork.stats();
+  EXPECT_EQ(stats.rangeQueries, 1u);
+  EXPECT_GT(stats.expressionCalls, 0u);
+  EXPECT_GE(stats.maxQueryDepth, 2u);
+}
+
+TEST_F(NetworkStatsTest, countsLongFailureChains)
+{
+  Wire& start = mNetwork.make("Start", 0);
+  Wire* wire = &start;
+  // A chain of additions, since the operators would build a single sum
+  for (std::size_t i = 0; i < Result::INLINE_CAPACITY; ++i)
+  {
+    wire = &mNetwork.add(*wire, mNetwork.constant(1));
+  }
+  *wire <= 100;
+  mNetwork.resetStats();
+  ASSERT_FALSE(start.set(200));
+  EXPECT_EQ(mNetwork.stats().resultAllocations, 1u);
+}
+
+TEST_F(NetworkStatsTest, resetClearsCounters)
+{
+  ASSERT_TRUE(mInput.set(2));
+  mNetwork.resetStats();
+  EXPECT_EQ(mNetwork.stats().propagations, 0u);
+  EXPECT_EQ(mNetwork.stats().operationsEvaluated, 0u);
+}
+
+#else
+
+TEST_F(NetworkStatsTest, countersStayZeroWhenDisabled)
+{
+  ASSERT_TRUE(mInput.set(2));
+  mInput.range();
+  NetworkStats stats = mNetwork.stats();
+  EXPECT_EQ(stats.propagations, 0u);
+  EXPECT_EQ(stats.operationsEvaluated, 0u);
+  EXPECT_EQ(stats.rangeQueries, 0u);
+}
+
+#endif
+
+}}
@@ -2,10 +2,16 @@
 
 #include "Network.h"
 
+#include "Bounds.h"
+#include "Equal.h"
 #include "LessOrEqual.h"
 
+#include "commonconstraintsCountingResource.h"
+
 #include <gtest/gtest.h>
 
+#include <vector>
+
 namespace common { namespace constraints {
 
 class NetworkTest : public ::testing::Test
@@ -130,6 +136,458 @@ TEST_F(NetworkTest, setValueFailsWhenInvalid)
   ASSERT_FALSE(w.set(Range::POSITIVE_INFINITY));
 }
 
+TEST_F(NetworkTest, setManyAppliesAllValuesBeforeVerifying)
+{
+  Network network;
+  Wire& a = network.make(60);
+  Wire& b = network.make(30);
+  Wire& sum = a + b;
+  sum <= 100;
+
+  // Setting a first on its own would exceed the limit
+  ASSERT_TRUE(network.setMany({{&a, 90}, {&b, 5}}));
+  ASSERT_EQ(a.get(), 90);
+  ASSERT_EQ(b.get(), 5);
+  ASSERT_EQ(sum.get(), 95);
+}
+
+TEST_F(NetworkTest, setManyRollsBackAllWiresOnFailure)
+{
+  Network network;
+  Wire& a = network.make(60);
+  Wire& b = network.make(30);
+  Wire& sum = a + b;
+  Wire& product = a * b;
+  sum <= 100;
+
+  Result r = network.setMany({{&a, 80}, {&b, 30}, {&a, 81}});
+  ASSERT_FALSE(r);
+  ASSERT_EQ(r.getErrorMessage(), "Wire1 + Wire2 would fail because "
+                                 "Wire1 + Wire2 <= 100 would fail.");
+  ASSERT_EQ(a.get(), 60);
+  ASSERT_EQ(b.get(), 30);
+  ASSERT_EQ(sum.get(), 90);
+  ASSERT_EQ(product.get(), 1800);
+}
+
+TEST_F(NetworkTest, computeAllRangesMatchesRangeOfEachWire)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  Wire& c = network.make("C", 3);
+  Wire& d = network.make("D", 4);
+  Wire& sum = a + b * c;
+  sum <= 100;
+  sum + sum + d <= 200;
+  a * d + c >= -20;
+  b <= d;
+  Wire& unconstrained = network.make("E", 5);
+  unconstrained * 2;
+
+  std::unordered_map<const Wire*, Range> ranges = network.computeAllRanges();
+  // Five named wires, the three literals of relations and seven driven wires,
+  // one of them the intermediate sum + sum; the factor 2 is a coefficient of
+  // a linear combination
+  ASSERT_EQ(ranges.size(), 15u);
+  for (auto& range : ranges)
+  {
+    ASSERT_EQ(range.second, range.first->range()) << range.first->getName();
+  }
+  ASSERT_EQ(ranges[&b], b.range());
+  ASSERT_EQ(ranges[&unconstrained], Range::FULL);
+}
+
+TEST_F(NetworkTest, computeAllRangesWithWireOnBothSidesOfProduct)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& zero = network.make("Zero", 0);
+  // Linear in x since the second factor does not vary with it
+  x * (x * zero) <= 5;
+  x <= 3;
+
+  std::unordered_map<const Wire*, Range> ranges = network.computeAllRanges();
+  ASSERT_EQ(ranges[&x], Range(Range::NEGATIVE_INFINITY, 3));
+  ASSERT_EQ(ranges[&x], x.range());
+  ASSERT_EQ(ranges[&zero], zero.range());
+}
+
+TEST_F(NetworkTest, computeAllRangesLeavesOutNonlinearWires)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& y = network.make("Y", 2);
+  Wire& sum = x + 1;
+  Wire& square = sum * sum;
+  square <= 10;
+  y <= 3;
+
+  std::unordered_map<const Wire*, Range> ranges = network.computeAllRanges();
+  ASSERT_EQ(ranges.count(&x), 0u);
+  ASSERT_EQ(ranges.count(&sum), 0u);
+  ASSERT_EQ(ranges[&square], square.range());
+  ASSERT_EQ(ranges[&y], Range(Range::NEGATIVE_INFINITY, 3));
+
+  network.indexRelations();
+  ASSERT_EQ(network.computeAllRanges().count(&x), 0u);
+}
+
+TEST_F(NetworkTest, computeAllRangesOfConstrainedChainAndDiamond)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  std::vector<Wire*> chain{&x};
+  for (int i = 0; i < 10; ++i)
+  {
+    chain.push_back(&(*chain.back() * 2 + 1));
+    *chain.back() <= 30000 - i;
+  }
+  // Reaches the last relation through both sides
+  Wire& p = x + 1;
+  p <= 10;
+  Wire& q = x * 3;
+  q <= 20;
+  p + q <= 25;
+
+  std::unordered_map<const Wire*, Range> ranges = network.computeAllRanges();
+  ASSERT_EQ(ranges[&x], Range(Range::NEGATIVE_INFINITY, 6));
+  for (auto& range : ranges)
+  {
+    ASSERT_EQ(range.second, range.first->range()) << range.first->getName();
+  }
+}
+
+TEST_F(NetworkTest, computeAllRangesThroughPiecewiseOperation)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& c = network.make("C", 3);
+  Wire& larger = max(a * 2, c);
+  // Holds for any value of the maximum, but only while C is the larger input
+  // is the maximum known to be constant
+  larger + a <= larger + 40;
+
+  std::unordered_map<const Wire*, Range> ranges = network.computeAllRanges();
+  ASSERT_EQ(ranges[&a], Range(Range::NEGATIVE_INFINITY, 1.5));
+  ASSERT_EQ(ranges[&a], a.range());
+}
+
+TEST_F(NetworkTest, literalsShareConstantWires)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& y = network.make("Y", 1);
+  Wire& sumX = x * 2 + 5;
+  Wire& sumY = y * 2 + 5;
+  ASSERT_EQ(&network.constant(2), &network.constant(2));
+  ASSERT_TRUE(network.constant(5).isConstant());
+  ASSERT_FALSE(x.isConstant());
+  ASSERT_EQ(sumX.getName(), "(X) * (2) + 5");
+  ASSERT_EQ(sumY.getName(), "(Y) * (2) + 5");
+  // X, Y, 2, 5 and the four operation outputs
+  ASSERT_EQ(network.compile().getWireCount(), 8u);
+}
+
+TEST_F(NetworkTest, constantOperationsAreFolded)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& folded = network.constant(2) * 3 + 4;
+  ASSERT_TRUE(folded.isConstant());
+  ASSERT_EQ(folded.get(), 10);
+  ASSERT_EQ(&folded, &network.constant(10));
+  x <= folded;
+  ASSERT_EQ(network.compile().getOperationCount(), 1u);
+  ASSERT_EQ(x.range(), Range(Range::NEGATIVE_INFINITY, 10));
+}
+
+TEST_F(NetworkTest, settingConstantFails)
+{
+  Network network;
+  Wire& x = network.make("X", 1);
+  Wire& limit = network.constant(2);
+  x <= limit;
+  Result result = limit.set(3);
+  ASSERT_FALSE(result);
+  ASSERT_EQ(result.getErrorMessage(), "Constant 2 cannot change, since every "
+                                      "use of its value shares it.");
+  ASSERT_TRUE(limit.set(2));
+  ASSERT_EQ(limit.get(), 2);
+  Result many = network.setMany({{&x, 0}, {&limit, 3}});
+  ASSERT_FALSE(many);
+  ASSERT_EQ(many.getErrorMessage(), result.getErrorMessage());
+  ASSERT_EQ(x.get(), 1);
+  ASSERT_EQ(x.range(), Range(Range::NEGATIVE_INFINITY, 2));
+}
+
+TEST_F(NetworkTest, subexpressionsAreSharedWhenEnabled)
+{
+  Network network;
+  network.setSubexpressionSharing(true);
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  Wire& sum = a + b;
+  ASSERT_EQ(&(b + a), &sum);
+  ASSERT_EQ(&(a * b), &(b * a));
+  ASSERT_NE(&(a * b), &sum);
+  sum <= 10;
+  sum <= 5;
+  ASSERT_EQ(network.compile().getOperationCount(), 4u);
+  ASSERT_TRUE(a.set(3));
+  ASSERT_EQ(sum.get(), 5);
+  ASSERT_EQ(a.range(), Range(Range::NEGATIVE_INFINITY, 3));
+}
+
+TEST_F(NetworkTest, subexpressionsAreNotSharedByDefault)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  ASSERT_NE(&(a + b), &(a + b));
+}
+
+TEST_F(NetworkTest, networkAllocatesFromGivenResource)
+{
+  CountingResource resource;
+  {
+    Network network(true, resource);
+    Wire* sum = &network.make("Start", 0);
+    for (int i = 0; i < 1000; ++i)
+    {
+      sum = &(*sum + network.make(i % 10));
+    }
+    *sum <= 10000;
+    ASSERT_EQ(sum->get(), 4500);
+    ASSERT_GT(network.getReservedBytes(), 0u);
+  }
+  // Blocks grow, so thousands of objects take a handful of allocations
+  ASSERT_LT(resource.allocations, 20);
+}
+
+TEST_F(NetworkTest, deepChainIsTraversedWithoutRecursion)
+{
+  // Deep enough to overflow the native stack if any traversal recursed
+  const int depth = 100000;
+  Network network;
+  Wire& start = network.make("Start", 1);
+  Wire& factor = network.make("Factor", 1);
+  Wire* product = &start;
+  for (int i = 0; i < depth; ++i)
+  {
+    product = &(*product * factor);
+  }
+  *product <= 2;
+
+  ASSERT_TRUE(start.set(2));
+  ASSERT_FALSE(start.check(3));
+  ASSERT_EQ(start.range(), Range(Range::NEGATIVE_INFINITY, 2));
+  const std::string name = product->getName();
+  ASSERT_EQ(name.size(), 13u * depth + 5);
+  ASSERT_EQ(name.compare(0, depth + 6, std::string(depth, '(') + "Start)"),
+            0);
+}
+
+TEST_F(NetworkTest, lazyEvaluationDefersWiresNoRelationDependsOn)
+{
+  Network network;
+  network.setLazyEvaluation(true);
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  Wire& product = a * b;
+  Wire& display = product * 3 + 1;
+  product <= 10;
+
+  network.resetStats();
+  ASSERT_TRUE(a.set(2));
+  ASSERT_EQ(product.get(), 4);
+#ifdef CONSTRAINTS_ENABLE_STATS
+  EXPECT_EQ(network.stats().operationsEvaluated, 2u);
+  EXPECT_EQ(network.stats().operationsDeferred, 1u);
+#endif
+  ASSERT_EQ(display.get(), 13);
+
+  // Neither checks nor failed transactions leave outdated values behind
+  ASSERT_TRUE(a.check(1));
+  ASSERT_FALSE(network.setMany({{&a, 3}, {&b, 4}}));
+  ASSERT_EQ(display.get(), 13);
+  ASSERT_TRUE(b.set(1));
+  ASSERT_EQ(display.get(), 7);
+}
+
+TEST_F(NetworkTest, relationOnOutdatedWireMakesItEager)
+{
+  Network network;
+  network.setLazyEvaluation(true);
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 4);
+  Wire& product = (a + 1) * b;
+  ASSERT_TRUE(a.set(2));
+
+  // The relation sees the current value when it is added
+  product <= 20;
+  ASSERT_EQ(product.get(), 12);
+  ASSERT_FALSE(a.set(5));
+  ASSERT_EQ(a.range(), Range(Range::NEGATIVE_INFINITY, 4));
+}
+
+TEST_F(NetworkTest, disablingLazyEvaluationUpdatesOutdatedWires)
+{
+  Network network;
+  network.setLazyEvaluation(true);
+  Wire& a = network.make("A", 1);
+  Wire& doubled = a * 2;
+  Wire& total = doubled + a;
+  ASSERT_TRUE(a.set(5));
+  network.setLazyEvaluation(false);
+
+  network.resetStats();
+  ASSERT_EQ(total.get(), 15);
+  ASSERT_EQ(doubled.get(), 10);
+#ifdef CONSTRAINTS_ENABLE_STATS
+  EXPECT_EQ(network.stats().operationsEvaluated, 0u);
+#endif
+  ASSERT_TRUE(a.set(1));
+  ASSERT_EQ(total.get(), 3);
+}
+
+TEST_F(NetworkTest, optimizeRemovesWhatNoRelationOrPinnedWireNeeds)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  Wire& product = a * b;
+  Wire& unused = product * 3;
+  Wire& display = a + b;
+  product <= 10;
+  network.pin(display);
+  network.optimize();
+  ASSERT_EQ(network.compile().getOperationCount(), 3u);
+
+  network.resetStats();
+  ASSERT_TRUE(a.set(3));
+  ASSERT_EQ(display.get(), 5);
+#ifdef CONSTRAINTS_ENABLE_STATS
+  EXPECT_EQ(network.stats().operationsEvaluated, 3u);
+#endif
+  // The removed sum keeps the value it had
+  ASSERT_EQ(unused.get(), 6);
+  ASSERT_FALSE(b.set(4));
+  ASSERT_EQ(a.range(), Range(Range::NEGATIVE_INFINITY, 2.5));
+}
+
+TEST_F(NetworkTest, optimizeMergesChainsOfLinearCombinations)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  // The product has a higher rank, so each sum starts a new combination
+  Wire& scaled = a * 2 + 1;
+  Wire& first = scaled + a * b;
+  Wire& second = first * 3 + a * b;
+  second <= 100;
+  const std::string name = second.getName();
+  network.optimize();
+
+  CompiledNetwork compiled = network.compile();
+  ASSERT_TRUE(a.set(2));
+  ASSERT_EQ(scaled.get(), 5);
+  ASSERT_EQ(first.get(), 9);
+  ASSERT_EQ(second.get(), 31);
+  ASSERT_EQ(second.getName(), name);
+  ASSERT_EQ(b.range(), Range(Range::NEGATIVE_INFINITY, 10.625));
+  ASSERT_FALSE(a.check(10));
+
+  // Only the last combination is evaluated when A changes
+  network.resetStats();
+  ASSERT_TRUE(a.set(3));
+#ifdef CONSTRAINTS_ENABLE_STATS
+  EXPECT_EQ(network.stats().operationsEvaluated, 4u);
+#endif
+  ASSERT_EQ(second.get(), 3 * (3 * 2 + 1 + 6) + 6);
+}
+
+TEST_F(NetworkTest, pinnedSumIsNotExtendedByOptimize)
+{
+  Network network;
+  Wire& a = network.make("A", 3);
+  Wire& c = network.make("C", 1);
+  Wire& d = network.make("D", 2);
+  Wire& e = network.make("E", 1);
+  Wire& f = network.make("F", 2);
+  Wire& first = max(c, d) + a;
+  network.pin(first);
+  Wire& second = first + max(e, f);
+  network.pin(second);
+  network.optimize();
+
+  ASSERT_TRUE(e.set(10));
+  ASSERT_EQ(first.get(), 5);
+  ASSERT_EQ(second.get(), 15);
+}
+
+TEST_F(NetworkTest, pinnedSumIsNotExtendedWithLazyEvaluation)
+{
+  Network network;
+  network.setLazyEvaluation(true);
+  Wire& a = network.make("A", 3);
+  Wire& c = network.make("C", 1);
+  Wire& d = network.make("D", 2);
+  Wire& e = network.make("E", 1);
+  Wire& f = network.make("F", 2);
+  Wire& first = max(c, d) + a;
+  network.pin(first);
+  Wire& second = first + max(e, f);
+  second <= 20;
+
+  ASSERT_FALSE(e.set(100));
+  ASSERT_TRUE(e.set(5));
+  ASSERT_EQ(second.get(), 10);
+  // Checking evaluates the sum, whose inputs must all be up to date
+  ASSERT_FALSE(c.check(20));
+  ASSERT_TRUE(c.check(7));
+}
+
+TEST_F(NetworkTest, relationIndexGivesRelationsDownstream)
+{
+  Network network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  Wire& c = network.make("C", 3);
+  Wire& product = a * b;
+  LessOrEqual& first = product <= 10;
+  Bounds& second = (a + c).within(0, 5);
+  const Range range = a.range();
+  network.indexRelations();
+
+  typedef std::vector<const IOperation*> List;
+  auto getRelations = [&](const Wire& wire) {
+    const IOperation::Relations& relations = network.getRelations(wire);
+    return List(relations.begin(), relations.end());
+  };
+  ASSERT_EQ(getRelations(a), (List{&first, &second}));
+  ASSERT_EQ(getRelations(b), List{&first});
+  ASSERT_EQ(getRelations(c), List{&second});
+  ASSERT_EQ(a.range(), range);
+
+  // Relations added afterwards are indexed as well
+  Wire& d = network.make("D", 0);
+  Equal& third = (product + d).equals(2);
+  ASSERT_EQ(network.getRelations(a).back(), &third);
+  ASSERT_EQ(network.getRelations(d).size(), 1u);
+  ASSERT_EQ(d.range(), Range(0, 0));
+
+  // A wire no relation depends on can take any value without propagating
+  Wire& e = network.make("E", 0);
+  e + 1;
+  network.resetStats();
+  ASSERT_TRUE(e.check(100));
+  ASSERT_FALSE(b.check(100));
+#ifdef CONSTRAINTS_ENABLE_STATS
+  EXPECT_EQ(network.stats().propagations, 1u);
+#endif
+}
+
 TEST_F(NetworkTest, nonlinearConstraintAssertsOnRange)
 {
   Network network(true);
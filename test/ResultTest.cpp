@@ -0,0 +1,51 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Result.h"
+
+#include "commonconstraintsMockOperation.h"
+
+#include <gtest/gtest.h>
+
+namespace common { namespace constraints {
+
+using ::testing::Return;
+using ::testing::StrictMock;
+
+TEST(ResultTest, successValue)
+{
+  ASSERT_TRUE(Result(true));
+  ASSERT_FALSE(Result(false));
+}
+
+TEST(ResultTest, messageListsOperationsInReversePushOrder)
+{
+  StrictMock<MockOperation> first;
+  StrictMock<MockOperation> second;
+  EXPECT_CALL(first, getErrorMessage()).WillOnce(Return("A fails"));
+  EXPECT_CALL(second, getErrorMessage()).WillOnce(Return("B because "));
+
+  Result r(false);
+  r.push(&first);
+  r.push(&second);
+  ASSERT_EQ(r.getErrorMessage(), "B because A fails.");
+}
+
+TEST(ResultTest, chainLongerThanInlineCapacity)
+{
+  std::vector<std::unique_ptr<StrictMock<MockOperation>>> operations;
+  Result r(false);
+  for (std::size_t i = 0; i < Result::INLINE_CAPACITY * 2 + 1; ++i)
+  {
+    operations.emplace_back(new StrictMock<MockOperation>());
+    EXPECT_CALL(*operations.back(), getErrorMessage())
+      .Times(2)
+      .WillRepeatedly(Return(std::to_string(i)));
+    r.push(operations.back().get());
+  }
+
+  const Result copy = r;
+  ASSERT_EQ(r.getErrorMessage(), "161514131211109876543210.");
+  ASSERT_EQ(copy.getErrorMessage(), "161514131211109876543210.");
+}
+
+}}
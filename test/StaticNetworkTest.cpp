@@ -0,0 +1,163 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "StaticNetwork.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace common { namespace constraints {
+
+TEST(StaticNetworkTest, supportsOperators)
+{
+  StaticNetwork<8, 8, 16, 16384> network;
+  Wire& height = network.make("Height", 1);
+  height * 2 + 5 <= 100;
+  ASSERT_FALSE(network.isCapacityExhausted());
+  ASSERT_TRUE(height.set(10));
+  ASSERT_FALSE(height.set(50));
+  ASSERT_EQ(height.range(), Range(Range::NEGATIVE_INFINITY, 47.5));
+}
+
+TEST(StaticNetworkTest, onlyTheBufferIsReserved)
+{
+  StaticNetwork<8, 8, 16, 16384> network;
+  Wire& height = network.make("Height", 1);
+  height * 2 + 5 <= 100;
+  const std::size_t used = network.getUsedBytes();
+  ASSERT_TRUE(height.set(10));
+  const std::pair<Wire*, Value> values[] = {{&height, 20}};
+  ASSERT_TRUE(network.setMany(values, 1));
+  ASSERT_EQ(network.getReservedBytes(), 16384u);
+  ASSERT_EQ(network.getUsedBytes(), used);
+}
+
+TEST(StaticNetworkTest, setManyFromArrayRollsBackOnFailure)
+{
+  StaticNetwork<8, 8, 16, 16384> network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  a + b <= 10;
+  const std::pair<Wire*, Value> values[] = {{&a, 4}, {&b, 7}};
+  ASSERT_FALSE(network.setMany(values, 2));
+  ASSERT_EQ(a.get(), 1);
+  ASSERT_EQ(b.get(), 2);
+  ASSERT_TRUE(network.setMany(values, 1));
+  ASSERT_EQ(a.get(), 4);
+}
+
+TEST(StaticNetworkTest, failureChainIsBounded)
+{
+  StaticNetwork<64, 64, 128, 65536> network;
+  Wire& input = network.make("Input", 0);
+  Wire* sum = &input;
+  // A chain of additions, since the operators would build a single sum
+  for (int i = 0; i < 20; ++i)
+  {
+    sum = &network.add(*sum, network.constant(1));
+  }
+  *sum <= 100;
+  Result result = input.set(90);
+  ASSERT_FALSE(result);
+
+  // The relation and the additions closest to it
+  const std::string message = result.getErrorMessage();
+  std::size_t operations = 0;
+  for (std::size_t position = message.find("would fail");
+       position != std::string::npos;
+       position = message.find("would fail", position + 1))
+  {
+    ++operations;
+  }
+  ASSERT_EQ(operations, Result::INLINE_CAPACITY);
+}
+
+TEST(StaticNetworkTest, exhaustedCapacityIsReported)
+{
+  StaticNetwork<2, 1, 2, 16384> network;
+  Wire& a = network.make("A", 1);
+  Wire& b = network.make("B", 2);
+  ASSERT_FALSE(network.isCapacityExhausted());
+  Wire& sum = a + b;
+  ASSERT_TRUE(network.isCapacityExhausted());
+  // Placeholders can be used, but are not part of the network
+  sum <= 0;
+  ASSERT_TRUE(a.set(100));
+  ASSERT_EQ(network.compile().getOperationCount(), 0u);
+}
+
+TEST(StaticNetworkTest, exhaustedNameCapacityIsReported)
+{
+  StaticNetwork<2, 0, 0, 8192, 8> network;
+  network.make("Short", 1);
+  ASSERT_FALSE(network.isCapacityExhausted());
+  network.make("Longer", 1);
+  ASSERT_TRUE(network.isCapacityExhausted());
+}
+
+TEST(StaticNetworkTest, fullCapacityFitsInBuffer)
+{
+  const std::size_t WIRES = 200;
+  const std::size_t BYTES = 256 * 1024;
+  StaticNetwork<WIRES, WIRES, 2 * WIRES, BYTES> network;
+  Wire& input = network.make("Input", 0);
+  Wire* sum = &input;
+  // Each step creates a constant wire and an output wire
+  for (std::size_t i = 0; i < (WIRES - 1) / 2; ++i)
+  {
+    sum = &(*sum + static_cast<double>(i));
+  }
+  for (std::size_t i = 0; i < WIRES - 1 - (WIRES - 1) / 2; ++i)
+  {
+    input <= *sum;
+  }
+  ASSERT_FALSE(network.isCapacityExhausted());
+  ASSERT_EQ(network.getReservedBytes(), BYTES);
+  ASSERT_TRUE(input.set(1));
+}
+
+/** Builds a chain of additions until the network is exhausted, and returns
+    the number of additions that were created.
+ */
+template <class StaticNetworkType>
+int buildUntilExhausted(StaticNetworkType& network)
+{
+  Wire& input = network.make("Input", 0);
+  Wire* sum = &input;
+  int created = 0;
+  while (!network.isCapacityExhausted())
+  {
+    Wire& next = network.add(*sum, network.constant(1));
+    if (network.isCapacityExhausted())
+    {
+      break;
+    }
+    sum = &next;
+    ++created;
+  }
+  *sum <= 1000;
+  return created;
+}
+
+TEST(StaticNetworkTest, exhaustedBufferIsReported)
+{
+  // The counts allow far more than fits in the buffer
+  StaticNetwork<100, 100, 200, 49152> first;
+  StaticNetwork<100, 100, 200, 49152> second;
+  const int created = buildUntilExhausted(first);
+  ASSERT_GT(created, 0);
+  ASSERT_EQ(buildUntilExhausted(second), created);
+  ASSERT_EQ(second.getUsedBytes(), first.getUsedBytes());
+  ASSERT_LE(first.getUsedBytes(), first.getReservedBytes());
+}
+
+TEST(StaticNetworkTest, bufferWithoutRoomForReservationsStartsExhausted)
+{
+  StaticNetwork<1000, 1000, 2000, 4096> network;
+  ASSERT_TRUE(network.isCapacityExhausted());
+  Wire& a = network.make("A", 1);
+  a + 1 <= 0;
+  ASSERT_EQ(network.compile().getOperationCount(), 0u);
+}
+
+}}
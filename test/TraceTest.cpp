@@ -0,0 +1,132 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#include "Trace.h"
+
+#include "LessOrEqual.h"
+#include "Network.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace common { namespace constraints {
+
+class TraceTest : public ::testing::Test
+{
+protected:
+  TraceTest()
+    : mBuffer(16)
+    , mInput(mNetwork.make("Input", 1))
+  {
+    mInput * 2 <= 10;
+  }
+
+  TraceEvent makeEvent(unsigned long long begin)
+  {
+    TraceEvent event = {TraceEvent::RANGE, nullptr, &mInput, begin, begin + 1};
+    return event;
+  }
+
+  TraceBuffer mBuffer;
+  Network mNetwork;
+  Wire& mInput;
+};
+
+TEST_F(TraceTest, bufferKeepsNewestEvents)
+{
+  for (unsigned long long i = 0; i < 20; ++i)
+  {
+    mBuffer.record(makeEvent(i));
+  }
+  std::vector<TraceEvent> events = mBuffer.getEvents();
+  ASSERT_EQ(events.size(), 16u);
+  ASSERT_EQ(events.front().begin, 4u);
+  ASSERT_EQ(events.back().begin, 19u);
+
+  mBuffer.clear();
+  ASSERT_TRUE(mBuffer.getEvents().empty());
+}
+
+TEST_F(TraceTest, concurrentWritersPublishEveryEvent)
+{
+  const unsigned long long THREADS = 4;
+  const unsigned long long EVENTS = 4096;
+  TraceBuffer buffer(THREADS * EVENTS);
+  std::vector<std::thread> writers;
+  for (unsigned long long thread = 0; thread < THREADS; ++thread)
+  {
+    writers.emplace_back([&, thread] {
+      for (unsigned long long i = 0; i < EVENTS; ++i)
+      {
+        buffer.record(makeEvent(thread * EVENTS + i));
+      }
+    });
+  }
+  for (auto& writer : writers)
+  {
+    writer.join();
+  }
+
+  std::vector<TraceEvent> events = buffer.getEvents();
+  ASSERT_EQ(events.size(), THREADS * EVENTS);
+  std::vector<unsigned long long> begins;
+  for (auto& event : events)
+  {
+    ASSERT_EQ(event.end, event.begin + 1);
+    begins.push_back(event.begin);
+  }
+  std::sort(begins.begin(), begins.end());
+  for (unsigned long long i = 0; i < begins.size(); ++i)
+  {
+    ASSERT_EQ(begins[i], i);
+  }
+}
+
+TEST_F(TraceTest, exportsChromeTraceEvents)
+{
+  mBuffer.record(makeEvent(2000));
+  std::ostringstream s;
+  mBuffer.exportChromeTrace(s);
+  ASSERT_EQ(s.str(),
+            "{\"traceEvents\":[\n"
+            "{\"name\":\"Input\",\"cat\":\"range\",\"ph\":\"X\","
+            "\"ts\":2.000,\"dur\":0.001,\"pid\":1,\"tid\":1}\n"
+            "]}\n");
+}
+
+#if defined(CONSTRAINTS_ENABLE_TRACING)
+
+TEST_F(TraceTest, recordsOperationsWhenEnabled)
+{
+  mNetwork.setTraceBuffer(&mBuffer);
+  ASSERT_TRUE(mInput.set(2));
+  mInput.range();
+  mNetwork.setTraceBuffer(nullptr);
+  mInput.set(3);
+
+  std::vector<TraceEvent> events = mBuffer.getEvents();
+  ASSERT_EQ(events[0].kind, TraceEvent::PROPAGATE);
+  ASSERT_EQ(events[1].kind, TraceEvent::PROPAGATE);
+  ASSERT_EQ(events.back().kind, TraceEvent::RANGE);
+  ASSERT_EQ(events.back().wire, &mInput);
+  for (auto& event : events)
+  {
+    ASSERT_LE(event.begin, event.end);
+  }
+}
+
+#else
+
+TEST_F(TraceTest, recordsNothingWhenDisabled)
+{
+  mNetwork.setTraceBuffer(&mBuffer);
+  ASSERT_TRUE(mInput.set(2));
+  mInput.range();
+  ASSERT_TRUE(mBuffer.getEvents().empty());
+}
+
+#endif
+
+}}
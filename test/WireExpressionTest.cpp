@@ -116,6 +116,20 @@ TEST_F(WireExpressionTest, commutativeMultiplication)
   ASSERT_EQ(c * d, d * c);
 }
 
+TEST_F(WireExpressionTest, domainsAreIntersected)
+{
+  WireExpression a = WireExpression::createLinear(1, 2);
+  a.domain = Range(0, 10);
+  WireExpression b = WireExpression::createLinear(3, 4);
+  b.domain = Range(5, 20);
+
+  ASSERT_EQ((a + b).domain, Range(5, 10));
+  ASSERT_EQ((a - b).domain, Range(5, 10));
+  ASSERT_EQ((a * b).domain, Range(5, 10));
+  ASSERT_EQ((a + WireExpression::createLinear(0, 1)).domain, a.domain);
+  ASSERT_FALSE(a == WireExpression::createLinear(1, 2));
+}
+
 TEST_F(WireExpressionTest, negativeConstantToString)
 {
   WireExpression e = WireExpression::createLinear(5, -3);
@@ -145,11 +159,18 @@ TEST_F(WireExpressionTest, positiveConstantToString)
 
 TEST_F(WireExpressionTest, fractionalToString)
 {
+#if defined(CONSTRAINTS_VALUE_FIXED)
+  // Q16.16 represents binary fractions only
+  WireExpression e = WireExpression::createLinear(5.25, -3.875);
+  const char* expected = "5.25*x - 3.875";
+#else
   WireExpression e = WireExpression::createLinear(5.2, -3.999);
+  const char* expected = "5.2*x - 3.999";
+#endif
 
   std::ostringstream s;
   s << e;
-  ASSERT_EQ(s.str(), "5.2*x - 3.999");
+  ASSERT_EQ(s.str(), expected);
 }
 
 TEST_F(WireExpressionTest, nonlinearToString)
@@ -5,6 +5,7 @@
 #include "Network.h"
 
 #include "commonconstraintsMockOperation.h"
+#include "commonconstraintsTolerance.h"
 
 #include <gtest/gtest.h>
 
@@ -14,6 +15,11 @@ using ::testing::_;
 using ::testing::Return;
 using ::testing::StrictMock;
 
+ACTION_P(WriteName, text)
+{
+  arg0.text(text);
+}
+
 class WireTest : public ::testing::Test
 {
 public:
@@ -30,7 +36,7 @@ protected:
 TEST_F(WireTest, getValue)
 {
   Wire& w = mNetwork.make(3.14);
-  ASSERT_EQ(w.get(), 3.14);
+  ASSERT_EQ(w.get(), Value(3.14));
 }
 
 TEST_F(WireTest, setValue)
@@ -110,7 +116,7 @@ TEST_F(WireTest, nameFromDriver)
   StrictMock<MockOperation> driver;
   Wire& w = mNetwork.make(42);
   setDriver(w, driver);
-  EXPECT_CALL(driver, getName()).WillOnce(Return("A + B"));
+  EXPECT_CALL(driver, writeName(_)).WillOnce(WriteName("A + B"));
 
   ASSERT_EQ(w.getName(), "Wire1: A + B");
 }
@@ -120,7 +126,7 @@ TEST_F(WireTest, nameGivenAndFromDriver)
   StrictMock<MockOperation> driver;
   Wire& w = mNetwork.make("Sum", 41);
   setDriver(w, driver);
-  EXPECT_CALL(driver, getName()).WillOnce(Return("A + B"));
+  EXPECT_CALL(driver, writeName(_)).WillOnce(WriteName("A + B"));
 
   ASSERT_EQ(w.getName(), "Sum: A + B");
 }
@@ -130,7 +136,7 @@ TEST_F(WireTest, descriptionWithNameGivenAndFromDriver)
   StrictMock<MockOperation> driver;
   Wire& w = mNetwork.make("Sum", 41);
   setDriver(w, driver);
-  EXPECT_CALL(driver, getName()).WillOnce(Return("A + B"));
+  EXPECT_CALL(driver, writeName(_)).WillOnce(WriteName("A + B"));
 
   ASSERT_EQ(w.getShortDescription(), "(Sum: A + B)=41");
 }
@@ -148,6 +154,111 @@ TEST_F(WireTest, valueAfterInvalidDoesNotRollBack)
   ASSERT_EQ(w.get(), 150);
 }
 
+TEST_F(WireTest, diamondEvaluatesDownstreamOperationOnce)
+{
+  Wire& w = mNetwork.make(1);
+  Wire& left = w + w;
+  Wire& right = w * w;
+  Wire& merged = left + right;
+  StrictMock<MockOperation> operation;
+
+  EXPECT_CALL(operation, propagateValue()).WillOnce(Return(Result(true)));
+  connect(merged, operation);
+  ASSERT_TRUE(w = 3);
+  ASSERT_EQ(merged.get(), 15);
+}
+
+TEST_F(WireTest, chainOfDiamondsIsUpToDate)
+{
+  Wire& w = mNetwork.make(0);
+  Wire* last = &w;
+  for (int i = 0; i < 40; ++i)
+  {
+    last = &(*last + *last);
+  }
+  ASSERT_TRUE(w = 1);
+  ASSERT_EQ(last->get(), 1099511627776.0);
+}
+
+TEST_F(WireTest, checkDoesNotModifyNetwork)
+{
+  Wire& a = mNetwork.make(10);
+  Wire& b = mNetwork.make(20);
+  Wire& sum = a + b;
+  sum <= 100;
+
+  ASSERT_TRUE(a.check(80));
+  ASSERT_FALSE(a.check(81));
+  ASSERT_EQ(a.get(), 10);
+  ASSERT_EQ(sum.get(), 30);
+}
+
+TEST_F(WireTest, checkReportsFailingChain)
+{
+  Wire& a = mNetwork.make(10);
+  Wire& b = mNetwork.make(20);
+  a + b <= 100;
+
+  Result r = a.check(81);
+  ASSERT_FALSE(r);
+  ASSERT_EQ(r.getErrorMessage(), "Wire1 + Wire2 would fail because "
+                                 "Wire1 + Wire2 <= 100 would fail.");
+  ASSERT_TRUE(b.set(90));
+}
+
+TEST_F(WireTest, expressionIsMemoizedUntilValueChanges)
+{
+  StrictMock<MockOperation> driver;
+  Wire& variable = mNetwork.make(1);
+  Wire& w = mNetwork.make(42);
+  setDriver(w, driver);
+
+  EXPECT_CALL(driver, appendInputs(_)).Times(2);
+  EXPECT_CALL(driver, expression(_))
+    .Times(2)
+    .WillRepeatedly(Return(WireExpression::createLinear(2, 1)));
+  ASSERT_EQ(w.expression(variable), WireExpression::createLinear(2, 1));
+  ASSERT_EQ(w.expression(variable), WireExpression::createLinear(2, 1));
+  variable.set(5);
+  ASSERT_EQ(w.expression(variable), WireExpression::createLinear(2, 1));
+}
+
+TEST_F(WireTest, sharedSubexpressionIsComputedOncePerRange)
+{
+  StrictMock<MockOperation> driver;
+  Wire& variable = mNetwork.make(1);
+  Wire& shared = mNetwork.make(0);
+  setDriver(shared, driver);
+  // Asked once when the relations mark what they depend on
+  EXPECT_CALL(driver, appendInputs(_));
+  Wire& once = variable + shared;
+  once <= 100;
+  once + shared <= 150;
+
+  // Once for each range query, although both relations depend on it
+  EXPECT_CALL(driver, expression(_))
+    .Times(2)
+    .WillRepeatedly(Return(WireExpression::createLinear(0, 10)));
+  ASSERT_EQ(variable.range(), Range(Range::NEGATIVE_INFINITY, 90));
+  ASSERT_EQ(variable.range(), Range(Range::NEGATIVE_INFINITY, 90));
+}
+
+TEST_F(WireTest, expressionCacheSurvivesQueriesWhenEnabled)
+{
+  StrictMock<MockOperation> driver;
+  Wire& variable = mNetwork.make(1);
+  Wire& w = mNetwork.make(0);
+  setDriver(w, driver);
+  EXPECT_CALL(driver, appendInputs(_));
+  variable + w <= 100;
+  mNetwork.setExpressionCaching(true);
+
+  EXPECT_CALL(driver, expression(_))
+    .WillOnce(Return(WireExpression::createLinear(0, 10)));
+  ASSERT_EQ(variable.range(), Range(Range::NEGATIVE_INFINITY, 90));
+  ASSERT_EQ(variable.range(), Range(Range::NEGATIVE_INFINITY, 90));
+}
+
 TEST_F(WireTest, implicitWireFromLiteral)
 {
   Wire& a = mNetwork.make(42);
@@ -174,4 +285,19 @@ TEST_F(WireTest, reversedOperators)
   100 >= a;
 }
 
+TEST_F(WireTest, rangeIsPreciseInValueType)
+{
+  Wire& a = mNetwork.make("A", 0.1);
+  Wire& b = mNetwork.make("B", 0.2);
+  a + b <= 1;
+  3 * b <= 1;
+
+  const Range rangeA = a.range();
+  ASSERT_EQ(rangeA.lower, Range::NEGATIVE_INFINITY);
+  ASSERT_NEAR(static_cast<double>(rangeA.upper), 0.8, TOLERANCE);
+  const Range rangeB = b.range();
+  ASSERT_EQ(rangeB.lower, Range::NEGATIVE_INFINITY);
+  ASSERT_NEAR(static_cast<double>(rangeB.upper), 1.0 / 3, TOLERANCE);
+}
+
 }}
@@ -0,0 +1,31 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "MemoryResource.h"
+
+namespace common { namespace constraints {
+
+/** Forwards to the default resource and counts the calls. */
+class CountingResource : public MemoryResource
+{
+public:
+  int allocations = 0;
+  int deallocations = 0;
+
+protected:
+  virtual void* doAllocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return getDefault().allocate(bytes, alignment);
+  }
+
+  virtual void
+  doDeallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocations;
+    getDefault().deallocate(pointer, bytes, alignment);
+  }
+};
+
+}}
@@ -12,11 +12,13 @@ class MockOperation : public IOperation
 public:
   MOCK_CONST_METHOD1(dump, std::string(unsigned int indentationLevel));
   MOCK_CONST_METHOD0(getShortDescription, std::string());
-  MOCK_CONST_METHOD0(getName, std::string());
   MOCK_METHOD0(propagateValue, Result());
   MOCK_CONST_METHOD1(range, Range(const IWire& varyingWire));
   MOCK_CONST_METHOD1(expression, WireExpression(const IWire& varyingWire));
   MOCK_CONST_METHOD0(getErrorMessage, std::string());
+  MOCK_CONST_METHOD1(compile, void(CompiledNetwork& compiled));
+  MOCK_CONST_METHOD1(appendInputs, void(Inputs& inputs));
+  MOCK_CONST_METHOD1(writeName, void(NameWriter& name));
 };
 
 } // namespace constraints
@@ -10,8 +10,8 @@ namespace common { namespace constraints {
 class MockWire : public IWire
 {
 public:
-  MOCK_CONST_METHOD0(get, double());
-  MOCK_METHOD1(set, Result(double value));
+  MOCK_CONST_METHOD0(get, Value());
+  MOCK_METHOD1(set, Result(Value value));
   MOCK_CONST_METHOD0(range, Range());
   MOCK_CONST_METHOD1(range, Range(const IWire& varyingWire));
   MOCK_CONST_METHOD1(expression, WireExpression(const IWire& varyingWire));
@@ -19,6 +19,7 @@ public:
   MOCK_CONST_METHOD0(getShortDescription, std::string());
   MOCK_CONST_METHOD0(getName, std::string());
   MOCK_METHOD1(connect, void(IOperation* operation));
+  MOCK_METHOD1(disconnect, void(IOperation* operation));
   MOCK_METHOD1(setDriver, void(IOperation* operation));
   MOCK_CONST_METHOD0(getNetwork, Network&());
 };
@@ -0,0 +1,20 @@
+// Copyright 2019 SICK AG. All rights reserved.
+
+#pragma once
+
+#include "Value.h"
+
+namespace common { namespace constraints {
+
+/** Absolute tolerance for comparing a few operations on values of order one
+    with their exact decimal results, depending on the selected value type.
+ */
+#if defined(CONSTRAINTS_VALUE_FLOAT)
+const double TOLERANCE = 1e-6;
+#elif defined(CONSTRAINTS_VALUE_FIXED)
+const double TOLERANCE = 1e-4;
+#else
+const double TOLERANCE = 1e-12;
+#endif
+
+}}